@@ -0,0 +1,309 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "doc_distance.hpp"
+
+// Maps each distinct word of a corpus to a dense term ID, 0, 1, 2, ...
+class vocabulary {
+private:
+  word_freq_table ids; // Stores ID + 1 as the count of the word.
+  uint32_t n;
+
+public:
+  vocabulary() : ids(1 << 16), n(0) {}
+
+  // ID of the word w[0, len), assigning the next free one if it is new.
+  uint32_t id(const char *w, size_t len) {
+    int v = ids.find(w, len);
+    if (v != 0)
+      return static_cast<uint32_t>(v - 1);
+    ids.add(w, len, static_cast<int>(++n));
+    return n - 1;
+  }
+
+  uint32_t size() const { return n; }
+};
+
+// Document as a sparse vector of (term ID, count), sorted by term ID.
+struct sparse_doc_t {
+  std::vector<uint32_t> terms;
+  std::vector<int32_t> counts;
+  double norm;
+};
+
+// Inner product of two sparse documents by merging their term lists.
+// Products are summed in increasing term order.
+inline double inner_product(const sparse_doc_t &d1, const sparse_doc_t &d2) {
+  double sum = 0.0;
+  size_t i = 0, j = 0;
+  while (i < d1.terms.size() && j < d2.terms.size()) {
+    if (d1.terms[i] < d2.terms[j]) {
+      ++i;
+    } else if (d2.terms[j] < d1.terms[i]) {
+      ++j;
+    } else {
+      sum += static_cast<double>(d1.counts[i]) * d2.counts[j];
+      ++i;
+      ++j;
+    }
+  }
+  return sum;
+}
+
+// Cosine of the angle between two documents.
+inline double cosine_similarity(const sparse_doc_t &d1,
+                                const sparse_doc_t &d2) {
+  return inner_product(d1, d2) / (d1.norm * d2.norm);
+}
+
+// Angle between two documents.
+inline double vector_angle(const sparse_doc_t &d1, const sparse_doc_t &d2) {
+  return std::acos(std::min(1.0, cosine_similarity(d1, d2)));
+}
+
+// A near neighbour of a document.
+struct neighbor_t {
+  uint32_t doc;
+  double sim;
+};
+
+// Strict order for the neighbour lists: higher similarity first, ties broken
+// by the lower document number.
+inline bool better_neighbor(const neighbor_t &a, const neighbor_t &b) {
+  return a.sim > b.sim || (a.sim == b.sim && a.doc < b.doc);
+}
+
+// Keeps the k best neighbours in heap; the worst of them is at the front.
+inline void push_top_k(std::vector<neighbor_t> &heap, size_t k,
+                       const neighbor_t &nb) {
+  if (heap.size() < k) {
+    heap.push_back(nb);
+    std::push_heap(heap.begin(), heap.end(), better_neighbor);
+  } else if (k > 0 && better_neighbor(nb, heap.front())) {
+    std::pop_heap(heap.begin(), heap.end(), better_neighbor);
+    heap.back() = nb;
+    std::push_heap(heap.begin(), heap.end(), better_neighbor);
+  }
+}
+
+// Collection of documents over a shared vocabulary, with an inverted index
+// (term -> documents containing it) in compressed sparse row form.
+class corpus {
+public:
+  struct posting_t {
+    uint32_t doc;
+    int32_t count;
+  };
+
+  std::vector<sparse_doc_t> docs;
+  vocabulary vocab;
+
+  // Postings of term t are postings[term_start[t], term_start[t + 1]),
+  // in increasing document order.
+  std::vector<size_t> term_start;
+  std::vector<posting_t> postings;
+
+  // Adds the documents texts[i]. The texts are tokenized and counted in
+  // parallel; the term IDs are then assigned serially, in document order.
+  void add_documents(const std::vector<std::string_view> &texts,
+                     size_t nthreads) {
+    std::vector<word_freq_table> tables(texts.size(), word_freq_table(64));
+    std::atomic<size_t> next(0);
+    auto count = [&]() {
+      for (size_t i; (i = next++) < texts.size();)
+        count_word_frequency(texts[i].data(), texts[i].size(), tables[i]);
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < nthreads; ++t)
+      workers.emplace_back(count);
+    count();
+    for (auto &w : workers)
+      w.join();
+
+    std::vector<std::pair<uint32_t, int32_t>> tc;
+    for (auto &ft : tables) {
+      tc.clear();
+      ft.for_each([&](const char *w, size_t len, int c) {
+        tc.emplace_back(vocab.id(w, len), c);
+      });
+      std::sort(tc.begin(), tc.end());
+
+      sparse_doc_t d;
+      d.terms.reserve(tc.size());
+      d.counts.reserve(tc.size());
+      for (const auto &p : tc) {
+        d.terms.push_back(p.first);
+        d.counts.push_back(p.second);
+      }
+      d.norm = ft.norm();
+      docs.push_back(std::move(d));
+    }
+  }
+
+  // Builds the inverted index with a counting sort of the postings by term.
+  void build_index() {
+    term_start.assign(vocab.size() + 1, 0);
+    for (const auto &d : docs)
+      for (auto t : d.terms)
+        ++term_start[t + 1];
+    for (size_t t = 0; t < vocab.size(); ++t)
+      term_start[t + 1] += term_start[t];
+
+    postings.resize(term_start.back());
+    std::vector<size_t> pos(term_start.begin(), term_start.end() - 1);
+    for (size_t i = 0; i < docs.size(); ++i)
+      for (size_t k = 0; k < docs[i].terms.size(); ++k)
+        postings[pos[docs[i].terms[k]]++] =
+            posting_t{static_cast<uint32_t>(i), docs[i].counts[k]};
+  }
+};
+
+// All-pairs cosine similarity: the k nearest neighbours of every document,
+// best first. Only documents sharing at least one term are neighbours.
+//
+// Without pruning the similarity matrix D.D' is computed tile by tile:
+// a tile of rows is merged against a tile of columns at a time so both stay
+// in cache. Every pair is evaluated.
+// With pruning (needs build_index) each row is accumulated from the
+// postings of its terms into a dense scratch row, so pairs with no shared
+// term are never touched.
+// Both compute the same sums in the same order and give identical output.
+//
+// Each row is computed in full, (i, j) as well as (j, i), so that the threads
+// own disjoint rows of the output and need no locking.
+inline std::vector<std::vector<neighbor_t>>
+all_pairs_top_k(const corpus &c, size_t k, size_t nthreads, bool prune) {
+  const size_t n = c.docs.size();
+  const size_t ROW_TILE = 64, COL_TILE = 256;
+  std::vector<std::vector<neighbor_t>> result(n);
+  std::atomic<size_t> next_tile(0);
+
+  auto blocked = [&]() {
+    for (size_t i0; (i0 = ROW_TILE * next_tile++) < n;) {
+      const size_t i1 = std::min(n, i0 + ROW_TILE);
+      for (size_t j0 = 0; j0 < n; j0 += COL_TILE) {
+        const size_t j1 = std::min(n, j0 + COL_TILE);
+        for (size_t i = i0; i < i1; ++i) {
+          const sparse_doc_t &di = c.docs[i];
+          for (size_t j = j0; j < j1; ++j) {
+            if (j == i)
+              continue;
+            double dot = inner_product(di, c.docs[j]);
+            if (dot > 0)
+              push_top_k(result[i], k,
+                         neighbor_t{static_cast<uint32_t>(j),
+                                    dot / (di.norm * c.docs[j].norm)});
+          }
+        }
+      }
+    }
+  };
+
+  auto pruned = [&]() {
+    std::vector<double> acc(n, 0.0);
+    std::vector<uint32_t> touched;
+    for (size_t i0; (i0 = ROW_TILE * next_tile++) < n;) {
+      const size_t i1 = std::min(n, i0 + ROW_TILE);
+      for (size_t i = i0; i < i1; ++i) {
+        const sparse_doc_t &di = c.docs[i];
+        for (size_t x = 0; x < di.terms.size(); ++x) {
+          const auto t = di.terms[x];
+          for (size_t p = c.term_start[t]; p < c.term_start[t + 1]; ++p) {
+            const auto &post = c.postings[p];
+            if (post.doc == i)
+              continue;
+            if (acc[post.doc] == 0.0)
+              touched.push_back(post.doc);
+            acc[post.doc] += static_cast<double>(di.counts[x]) * post.count;
+          }
+        }
+        for (auto j : touched) {
+          push_top_k(result[i], k,
+                     neighbor_t{j, acc[j] / (di.norm * c.docs[j].norm)});
+          acc[j] = 0.0;
+        }
+        touched.clear();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < nthreads; ++t) {
+    if (prune)
+      workers.emplace_back(pruned);
+    else
+      workers.emplace_back(blocked);
+  }
+  if (prune)
+    pruned();
+  else
+    blocked();
+  for (auto &w : workers)
+    w.join();
+
+  for (auto &r : result)
+    std::sort_heap(r.begin(), r.end(), better_neighbor);
+  return result;
+}
+
+#define NUM_TOPICS 1000
+#define TOPIC_WORDS 200
+#define GLOBAL_WORDS 200000
+
+// Synthetic corpus. Every document has a topic; most of its words come from
+// the topic's word list and the rest uniformly from a large global list.
+// One document in ten is a near-duplicate of an earlier one, with about a
+// tenth of its words replaced.
+inline std::vector<std::string> generate_corpus(size_t ndocs) {
+  auto word = [](size_t id) {
+    std::string w;
+    for (size_t x = id + 1; x; x /= 26)
+      w.push_back(static_cast<char>('a' + x % 26));
+    return w;
+  };
+
+  std::vector<std::string> texts(ndocs);
+  for (size_t d = 0; d < ndocs; ++d) {
+    std::string &text = texts[d];
+    if (d > 0 && rand() % 10 == 0) {
+      const std::string &orig = texts[rand() % d];
+      size_t from = 0;
+      for (size_t to; (to = orig.find(' ', from)) != std::string::npos;
+           from = to + 1) {
+        if (rand() % 10 == 0)
+          text += word(NUM_TOPICS * TOPIC_WORDS + rand() % GLOBAL_WORDS);
+        else
+          text.append(orig, from, to - from);
+        text += ' ';
+      }
+      continue;
+    }
+
+    const size_t topic = rand() % NUM_TOPICS;
+    const size_t len = 50 + rand() % 250;
+    for (size_t i = 0; i < len; ++i) {
+      if (rand() % 5 != 0)
+        text += word(topic * TOPIC_WORDS + rand() % (1 + rand() % TOPIC_WORDS));
+      else
+        text += word(NUM_TOPICS * TOPIC_WORDS + rand() % GLOBAL_WORDS);
+      text += ' ';
+    }
+  }
+  return texts;
+}
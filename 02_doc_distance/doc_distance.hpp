@@ -0,0 +1,469 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Hash-map of word to frequency.
+typedef std::unordered_map<std::string, int> freq_table_t;
+
+// Dumps a frequency table to ostream.
+inline std::ostream &operator<<(std::ostream &os, const freq_table_t &ft) {
+  for (auto &p : ft)
+    os << p.first << " : " << p.second << std::endl;
+  return os;
+}
+
+// Extracts words from a string, converts to lowercase and
+// adds to its count in the frequency table.
+inline void count_word_frequency(const std::string str, freq_table_t &ft) {
+  std::string word;
+
+  for (std::string::size_type i = 0; i < str.length(); ++i) {
+    if (std::isalnum(str.at(i))) {
+      word.push_back(static_cast<char>(tolower(str.at(i))));
+    } else if (!word.empty()) { // Non-alpha-numeric; end of current word.
+      ++ft[word];
+      word.clear();
+    }
+  }
+
+  // Last word
+  if (!word.empty()) {
+    ++ft[word];
+    word.clear();
+  }
+}
+
+// Reads a flie line-by-line, extracts words from each line and updates
+// their frequency in frequency table.
+inline void count_file_word_frequency(const std::string &fname,
+                                      freq_table_t &ft) {
+  std::ifstream infile(fname);
+  std::string line;
+  while (std::getline(infile, line)) {
+    count_word_frequency(line, ft);
+  }
+}
+
+// Inner product of two frequency tables.
+inline double inner_product(const freq_table_t &f1, const freq_table_t &f2) {
+  double sum = 0.0;
+  for (const auto &p : f1) {
+    const auto i = f2.find(p.first);
+    if (i != f2.end()) {
+      sum += static_cast<double>(p.second) * i->second;
+    }
+  }
+
+  return sum;
+}
+
+// Angle of two frequency tables.
+inline double vector_angle(const freq_table_t &f1, const freq_table_t &f2) {
+  auto numerator = inner_product(f1, f2);
+  auto denominator = std::sqrt(inner_product(f1, f1) * inner_product(f2, f2));
+  return std::acos(numerator / denominator);
+}
+
+//
+// Streaming engine.
+//
+// Words are the maximal runs of ASCII letters and digits, exactly as
+// std::isalnum classifies them in the "C" locale; every other byte, including
+// all bytes >= 0x80, is a separator.
+//
+
+namespace doc_distance_util {
+
+inline bool is_word_char(char ch) {
+  unsigned char c = static_cast<unsigned char>(ch);
+  return static_cast<unsigned char>((c | 0x20) - 'a') < 26 ||
+         static_cast<unsigned char>(c - '0') < 10;
+}
+
+// Bit mask of the alpha-numeric bytes in p[0, 64): bit i set if p[i] is.
+inline uint64_t alnum_mask64_scalar(const char *p) {
+  uint64_t mask = 0;
+  for (int i = 0; i < 64; ++i)
+    mask |= static_cast<uint64_t>(is_word_char(p[i])) << i;
+  return mask;
+}
+
+#if defined(__x86_64__)
+// Classifies 32 bytes at a time with signed byte compares. Bytes >= 0x80 are
+// negative and fail the lower bound of both ranges.
+__attribute__((target("avx2"))) inline uint32_t
+alnum_mask32_avx2(const char *p) {
+  __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  __m256i lc = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+  __m256i letter =
+      _mm256_and_si256(_mm256_cmpgt_epi8(lc, _mm256_set1_epi8('a' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lc));
+  __m256i digit =
+      _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+  return static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_or_si256(letter, digit)));
+}
+
+__attribute__((target("avx2"))) inline uint64_t
+alnum_mask64_avx2(const char *p) {
+  return alnum_mask32_avx2(p) |
+         (static_cast<uint64_t>(alnum_mask32_avx2(p + 32)) << 32);
+}
+#endif
+
+typedef uint64_t (*alnum_mask64_fn)(const char *);
+
+inline alnum_mask64_fn select_alnum_mask64() {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx2"))
+    return alnum_mask64_avx2;
+#endif
+  return alnum_mask64_scalar;
+}
+
+// Calls visit(word, len) for every word of data[0, n), in order.
+// The words are reported in place; nothing is copied or allocated.
+template <typename VISIT>
+void for_each_word(const char *data, size_t n, VISIT &&visit) {
+  static const alnum_mask64_fn mask64 = select_alnum_mask64();
+
+  size_t start = 0; // Start of the current word, if in_word.
+  bool in_word = false;
+
+  for (size_t base = 0; base < n; base += 64) {
+    uint64_t m;
+    if (base + 64 <= n) {
+      m = mask64(data + base);
+    } else {
+      // Tail; pad with separators.
+      char tail[64];
+      memset(tail, ' ', sizeof(tail));
+      memcpy(tail, data + base, n - base);
+      m = alnum_mask64_scalar(tail);
+    }
+
+    // Jump from boundary to boundary with count-trailing-zeros.
+    size_t pos = 0;
+    while (pos < 64) {
+      uint64_t rest = (in_word ? ~m : m) >> pos;
+      if (rest == 0)
+        break; // No boundary in the rest of this block.
+      pos += __builtin_ctzll(rest);
+      if (in_word)
+        visit(data + start, base + pos - start);
+      else
+        start = base + pos;
+      in_word = !in_word;
+    }
+  }
+
+  if (in_word)
+    visit(data + start, n - start);
+}
+
+} // namespace doc_distance_util
+
+// Word frequency table with open addressing and linear probing.
+// Slots are flat 16 byte records; the lowercase text of each distinct word is
+// appended once to a shared character pool, so counting an already seen word
+// does not allocate.
+class word_freq_table {
+private:
+  struct slot_t {
+    uint32_t hash; // High half of the 64 bit word hash.
+    uint32_t len;  // 0 for an empty slot.
+    uint32_t offset;
+    int32_t count;
+  };
+
+  std::vector<slot_t> slots;
+  std::vector<char> pool;
+  size_t used;
+  mutable double cached_norm;
+  mutable bool norm_valid;
+
+  bool same_word(const slot_t &s, const char *w, size_t len) const {
+    if (s.len != len)
+      return false;
+    const char *p = pool.data() + s.offset;
+    for (size_t i = 0; i < len; ++i)
+      if (p[i] != (w[i] | 0x20))
+        return false;
+    return true;
+  }
+
+  size_t probe(uint64_t h, const char *w, size_t len) const {
+    size_t mask = slots.size() - 1;
+    uint32_t tag = static_cast<uint32_t>(h >> 32);
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      const slot_t &s = slots[i];
+      if (s.len == 0 || (s.hash == tag && same_word(s, w, len)))
+        return i;
+    }
+  }
+
+  // Doubles the table when it is half full.
+  void grow() {
+    std::vector<slot_t> old(slots.size() * 2, slot_t{0, 0, 0, 0});
+    old.swap(slots);
+    size_t mask = slots.size() - 1;
+    for (const auto &s : old) {
+      if (s.len == 0)
+        continue;
+      uint64_t h = hash_word(pool.data() + s.offset, s.len);
+      size_t i = h & mask;
+      while (slots[i].len != 0)
+        i = (i + 1) & mask;
+      slots[i] = s;
+    }
+  }
+
+public:
+  // FNV-1a of the lowercase word; alpha-numeric ASCII lowercases with an or.
+  static uint64_t hash_word(const char *w, size_t len) {
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; ++i) {
+      h ^= static_cast<unsigned char>(w[i] | 0x20);
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  explicit word_freq_table(size_t capacity = 1024)
+      : used(0), cached_norm(0.0), norm_valid(false) {
+    size_t n = 16;
+    while (n < 2 * capacity)
+      n <<= 1;
+    slots.assign(n, slot_t{0, 0, 0, 0});
+  }
+
+  // Adds count occurrences of the word w[0, len). Upper case letters count
+  // as lower case.
+  void add(const char *w, size_t len, int count = 1) {
+    add_hashed(hash_word(w, len), w, len, count);
+  }
+
+  // add with the hash_word of the word already at hand.
+  void add_hashed(uint64_t h, const char *w, size_t len, int count = 1) {
+    norm_valid = false;
+    size_t i = probe(h, w, len);
+    if (slots[i].len != 0) {
+      slots[i].count += count;
+      return;
+    }
+
+    slots[i] = slot_t{static_cast<uint32_t>(h >> 32),
+                      static_cast<uint32_t>(len),
+                      static_cast<uint32_t>(pool.size()), count};
+    for (size_t k = 0; k < len; ++k)
+      pool.push_back(static_cast<char>(w[k] | 0x20));
+    if (2 * ++used > slots.size())
+      grow();
+  }
+
+  // Frequency of the word w[0, len); 0 if absent.
+  int find(const char *w, size_t len) const {
+    size_t i = probe(hash_word(w, len), w, len);
+    return slots[i].count;
+  }
+
+  // Number of distinct words.
+  size_t distinct() const { return used; }
+
+  // Calls visit(word, len, count) for each distinct word.
+  template <typename VISIT> void for_each(VISIT &&visit) const {
+    for (const auto &s : slots)
+      if (s.len != 0)
+        visit(pool.data() + s.offset, static_cast<size_t>(s.len), s.count);
+  }
+
+  // Euclidean norm of the frequency vector; computed once and cached till
+  // the next add.
+  double norm() const {
+    if (!norm_valid) {
+      double sum = 0.0;
+      for (const auto &s : slots)
+        sum += static_cast<double>(s.count) * s.count;
+      cached_norm = std::sqrt(sum);
+      norm_valid = true;
+    }
+    return cached_norm;
+  }
+
+  freq_table_t to_freq_table() const {
+    freq_table_t ft;
+    for_each([&ft](const char *w, size_t len, int count) {
+      ft.emplace(std::string(w, len), count);
+    });
+    return ft;
+  }
+};
+
+// Tokenizes text[0, n) and counts its words into ft.
+inline void count_word_frequency(const char *text, size_t n,
+                                 word_freq_table &ft) {
+  doc_distance_util::for_each_word(
+      text, n, [&ft](const char *w, size_t len) { ft.add(w, len); });
+}
+
+// Counts the words of a file through a memory map. Returns false if the
+// file cannot be opened.
+inline bool count_file_word_frequency(const std::string &fname,
+                                      word_freq_table &ft) {
+  mapped_file mf(fname);
+  if (!mf.valid())
+    return false;
+  count_word_frequency(mf.data(), mf.size(), ft);
+  return true;
+}
+
+// Inner product of two frequency tables; iterates the smaller one.
+inline double inner_product(const word_freq_table &f1,
+                            const word_freq_table &f2) {
+  if (f1.distinct() > f2.distinct())
+    return inner_product(f2, f1);
+  double sum = 0.0;
+  f1.for_each([&](const char *w, size_t len, int count) {
+    sum += static_cast<double>(count) * f2.find(w, len);
+  });
+  return sum;
+}
+
+// Angle of two frequency tables; one pass over the smaller table, the norms
+// come from the cache.
+inline double vector_angle(const word_freq_table &f1,
+                           const word_freq_table &f2) {
+  return std::acos(inner_product(f1, f2) / (f1.norm() * f2.norm()));
+}
+
+// Parallel word count.
+// The text is cut into nthreads chunks at word boundaries. Each thread
+// tokenizes its chunk into nthreads thread-local tables, one per hash
+// partition, i.e. by the high bits of the word hash. Partition p of all the
+// threads is then merged by thread p into parts[p]; the partitions hold
+// disjoint sets of words, so the merge needs no locking.
+inline void count_word_frequency_parallel(const char *text, size_t n,
+                                          size_t nthreads,
+                                          std::vector<word_freq_table> &parts) {
+  nthreads = std::max<size_t>(1, nthreads);
+  auto partition = [nthreads](uint64_t h) {
+    return static_cast<size_t>(((h >> 32) * nthreads) >> 32);
+  };
+
+  // Chunk t is text[cut[t], cut[t + 1]); a cut inside a word moves to the
+  // end of the word.
+  std::vector<size_t> cut(nthreads + 1, n);
+  cut[0] = 0;
+  for (size_t t = 1; t < nthreads; ++t) {
+    size_t pos = std::max(cut[t - 1], t * (n / nthreads));
+    while (pos > 0 && pos < n &&
+           doc_distance_util::is_word_char(text[pos - 1]) &&
+           doc_distance_util::is_word_char(text[pos]))
+      ++pos;
+    cut[t] = pos;
+  }
+
+  std::vector<std::vector<word_freq_table>> local(nthreads);
+  auto count = [&](size_t t) {
+    local[t].assign(nthreads, word_freq_table());
+    doc_distance_util::for_each_word(
+        text + cut[t], cut[t + 1] - cut[t], [&](const char *w, size_t len) {
+          uint64_t h = word_freq_table::hash_word(w, len);
+          local[t][partition(h)].add_hashed(h, w, len);
+        });
+  };
+
+  auto merge = [&](size_t p) {
+    // Start from the largest local table and add the others into it.
+    size_t largest = 0;
+    for (size_t t = 1; t < nthreads; ++t)
+      if (local[t][p].distinct() > local[largest][p].distinct())
+        largest = t;
+    std::swap(parts[p], local[largest][p]);
+    for (size_t t = 0; t < nthreads; ++t)
+      local[t][p].for_each([&](const char *w, size_t len, int c) {
+        parts[p].add(w, len, c);
+      });
+  };
+
+  auto run = [nthreads](auto func) {
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < nthreads; ++t)
+      workers.emplace_back(func, t);
+    func(0);
+    for (auto &w : workers)
+      w.join();
+  };
+
+  parts.assign(nthreads, word_freq_table());
+  run(count);
+  run(merge);
+}
+
+// Counts the words of a file in parallel through a memory map. Returns
+// false if the file cannot be opened.
+inline bool count_file_word_frequency_parallel(
+    const std::string &fname, size_t nthreads,
+    std::vector<word_freq_table> &parts) {
+  mapped_file mf(fname);
+  if (!mf.valid())
+    return false;
+  count_word_frequency_parallel(mf.data(), mf.size(), nthreads, parts);
+  return true;
+}
+
+// Writes about mbytes MB of random text over a fixed vocabulary with a
+// skewed (roughly Zipf-like) word distribution, for benchmarking when no
+// large corpus is at hand.
+inline void generate_text(const std::string &fname, size_t mbytes) {
+  const size_t VOCAB = 100000;
+  std::vector<std::string> vocab(VOCAB);
+  for (auto &w : vocab) {
+    size_t len = 1 + rand() % 12;
+    for (size_t i = 0; i < len; ++i)
+      w.push_back(static_cast<char>('a' + rand() % 26));
+  }
+
+  const char *seps[] = {" ", " ", " ", ", ", ". ", "\n", " -- ", "; "};
+  std::ofstream out(fname);
+  std::string line;
+  size_t written = 0;
+  while (written < mbytes * 1024 * 1024) {
+    // Small indices are far more likely than large ones.
+    std::string w = vocab[rand() % (1 + rand() % VOCAB)];
+    if (rand() % 8 == 0)
+      w[0] = static_cast<char>(w[0] - 'a' + 'A');
+    line += w;
+    line += seps[rand() % 8];
+    if (line.size() >= 4096) {
+      out << line;
+      written += line.size();
+      line.clear();
+    }
+  }
+  out << line << std::endl;
+}
@@ -0,0 +1,162 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "doc_distance.hpp"
+
+// Mersenne prime 2 ^ 31 - 1: modulus of the universal hash functions.
+#define MERSENNE_PRIME_31 2147483647ULL
+
+// Fibonacci hashing multiplier: 2 ^ 64 / phi.
+#define FIBONACCI_MULTIPLIER_64 11400714819323198485ULL
+
+// MinHash signatures.
+// A document is reduced to the set of its distinct words. Each of K universal
+// hash functions, h(x) = ((A * x + B) mod P) with P prime, maps the words to
+// [0, P); the signature keeps the minimum of every function. Two signatures
+// agree in a position with probability equal to the Jaccard similarity of
+// the word sets.
+class minhash {
+private:
+  std::vector<uint64_t> A; // Random numbers between 1 and (P - 1)
+  std::vector<uint64_t> B; // Random numbers between 0 and (P - 1)
+
+  // x mod (2 ^ 31 - 1) for x < 2 ^ 62, without a division.
+  static uint64_t mod_p(uint64_t x) {
+    x = (x & MERSENNE_PRIME_31) + (x >> 31);
+    x = (x & MERSENNE_PRIME_31) + (x >> 31);
+    return (x >= MERSENNE_PRIME_31) ? x - MERSENNE_PRIME_31 : x;
+  }
+
+public:
+  // The hash functions are drawn with rand(); seed it for repeatable
+  // signatures.
+  explicit minhash(size_t k) : A(k), B(k) {
+    for (size_t i = 0; i < k; ++i) {
+      A[i] = 1 + rand() % (MERSENNE_PRIME_31 - 1);
+      B[i] = rand() % MERSENNE_PRIME_31;
+    }
+  }
+
+  size_t size() const { return A.size(); }
+
+  // Signature of the words of ft, into sig[0, size()).
+  void signature(const word_freq_table &ft, uint32_t *sig) const {
+    const size_t k = A.size();
+    std::fill(sig, sig + k, static_cast<uint32_t>(MERSENNE_PRIME_31));
+    ft.for_each([&](const char *w, size_t len, int) {
+      const uint64_t x = mod_p(word_freq_table::hash_word(w, len) >> 2);
+      for (size_t i = 0; i < k; ++i) {
+        const uint32_t h = static_cast<uint32_t>(mod_p(A[i] * x + B[i]));
+        sig[i] = std::min(sig[i], h);
+      }
+    });
+  }
+
+  // Band keys for an LSH index: the signature is cut into bands of rows
+  // consecutive values and each band is hashed to one key.
+  static void band_keys(const uint32_t *sig, size_t bands, size_t rows,
+                        uint64_t *keys) {
+    for (size_t b = 0; b < bands; ++b) {
+      uint64_t h = 14695981039346656037ULL;
+      for (size_t r = 0; r < rows; ++r) {
+        h ^= sig[b * rows + r];
+        h *= 1099511628211ULL;
+      }
+      keys[b] = h;
+    }
+  }
+
+  // Fraction of agreeing positions: estimate of the Jaccard similarity.
+  static double estimate(const uint32_t *s1, const uint32_t *s2, size_t k) {
+    size_t same = 0;
+    for (size_t i = 0; i < k; ++i)
+      same += (s1[i] == s2[i]);
+    return static_cast<double>(same) / k;
+  }
+};
+
+// SimHash (Charikar) fingerprints.
+// Every word gets a 64 bit fingerprint by multiplication (Fibonacci) hashing
+// of its hash. Each fingerprint bit adds the word count to, or subtracts it
+// from, a per bit sum; the sign of the sums gives the document fingerprint.
+// Two fingerprints differ in a bit with probability angle / pi, where angle
+// is the vector_angle of the two frequency vectors.
+class simhash {
+public:
+  static uint64_t fingerprint(const word_freq_table &ft) {
+    int64_t v[64] = {0};
+    ft.for_each([&](const char *w, size_t len, int count) {
+      uint64_t f = word_freq_table::hash_word(w, len) * FIBONACCI_MULTIPLIER_64;
+      for (int b = 0; b < 64; ++b)
+        v[b] += ((f >> b) & 1) ? count : -count;
+    });
+    uint64_t fp = 0;
+    for (int b = 0; b < 64; ++b)
+      fp |= static_cast<uint64_t>(v[b] > 0) << b;
+    return fp;
+  }
+
+  // Band keys: bands consecutive bit fields of 64 / bands bits, each tagged
+  // with its band number.
+  static void band_keys(uint64_t fp, size_t bands, uint64_t *keys) {
+    const size_t width = 64 / bands;
+    const uint64_t mask = (width == 64) ? ~0ULL : ((1ULL << width) - 1);
+    for (size_t b = 0; b < bands; ++b)
+      keys[b] = ((fp >> (b * width)) & mask) * FIBONACCI_MULTIPLIER_64 + b;
+  }
+
+  // Estimate of the vector_angle of the two documents.
+  static double estimate_angle(uint64_t f1, uint64_t f2) {
+    return 3.14159265358979323846 * __builtin_popcountll(f1 ^ f2) / 64;
+  }
+};
+
+// Locality sensitive hashing index over band keys.
+// Documents with equal keys in any band are candidates for each other.
+// Each band is a flat array of (key, document) sorted by key; a lookup is a
+// binary search.
+class lsh_index {
+private:
+  size_t bands;
+  std::vector<std::vector<std::pair<uint64_t, uint32_t>>> buckets;
+
+public:
+  explicit lsh_index(size_t _bands) : bands(_bands), buckets(_bands) {}
+
+  // keys[d * bands + b] is the key of document d in band b.
+  void build(const uint64_t *keys, size_t ndocs) {
+    for (size_t b = 0; b < bands; ++b) {
+      auto &bucket = buckets[b];
+      bucket.resize(ndocs);
+      for (size_t d = 0; d < ndocs; ++d)
+        bucket[d] =
+            std::make_pair(keys[d * bands + b], static_cast<uint32_t>(d));
+      std::sort(bucket.begin(), bucket.end());
+    }
+  }
+
+  // Calls visit(doc) for each document sharing a band key with keys[0,
+  // bands). A document sharing several bands is visited once per band.
+  template <typename VISIT>
+  void candidates(const uint64_t *keys, VISIT &&visit) const {
+    for (size_t b = 0; b < bands; ++b) {
+      const auto &bucket = buckets[b];
+      auto it = std::lower_bound(bucket.begin(), bucket.end(),
+                                 std::make_pair(keys[b], uint32_t(0)));
+      for (; it != bucket.end() && it->first == keys[b]; ++it)
+        visit(it->second);
+    }
+  }
+};
@@ -0,0 +1,101 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "doc_distance.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+double mb_per_sec(size_t bytes, double ms) {
+  return bytes / (1024.0 * 1024.0) / (ms / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+  std::string f1, f2;
+  if (argc == 3) {
+    f1 = argv[1];
+    f2 = argv[2];
+  } else if (argc == 2) {
+    // Generate two files of the given size in MB.
+    srand(A_BIG_PRIME_NUMBER);
+    size_t mb = std::stoul(argv[1]);
+    f1 = "doc_distance_bench_1.txt";
+    f2 = "doc_distance_bench_2.txt";
+    generate_text(f1, mb);
+    generate_text(f2, mb);
+  } else {
+    std::cerr << "Usage: " << argv[0] << " file1 file2" << std::endl;
+    std::cerr << "       " << argv[0] << " size_in_mb" << std::endl;
+    return 1;
+  }
+
+  size_t bytes = 0;
+  {
+    mapped_file m1(f1), m2(f2);
+    if (!m1.valid() || !m2.valid()) {
+      std::cerr << "Cannot open input files" << std::endl;
+      return 1;
+    }
+    bytes = m1.size() + m2.size();
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  freq_table_t ft1, ft2;
+  count_file_word_frequency(f1, ft1);
+  count_file_word_frequency(f2, ft2);
+  auto t2 = std::chrono::high_resolution_clock::now();
+  double angle = vector_angle(ft1, ft2);
+  auto t3 = std::chrono::high_resolution_clock::now();
+
+  word_freq_table wt1, wt2;
+  count_file_word_frequency(f1, wt1);
+  count_file_word_frequency(f2, wt2);
+  auto t4 = std::chrono::high_resolution_clock::now();
+  double fast_angle = vector_angle(wt1, wt2);
+  auto t5 = std::chrono::high_resolution_clock::now();
+
+  auto ms = [](decltype(t1) a, decltype(t1) b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+  };
+
+  std::cout << "Input: " << bytes << " bytes, distinct words: "
+            << wt1.distinct() << ", " << wt2.distinct() << std::endl;
+  std::cout << "       engine   count (ms)   angle (ms)         MB/s"
+               "        angle"
+            << std::endl;
+
+  std::cout.width(13);
+  std::cout << "getline/map";
+  std::cout.width(13);
+  std::cout << ms(t1, t2);
+  std::cout.width(13);
+  std::cout << ms(t2, t3);
+  std::cout.width(13);
+  std::cout << mb_per_sec(bytes, ms(t1, t2));
+  std::cout.width(13);
+  std::cout << angle << std::endl;
+
+  std::cout.width(13);
+  std::cout << "mmap/flat";
+  std::cout.width(13);
+  std::cout << ms(t3, t4);
+  std::cout.width(13);
+  std::cout << ms(t4, t5);
+  std::cout.width(13);
+  std::cout << mb_per_sec(bytes, ms(t3, t4));
+  std::cout.width(13);
+  std::cout << fast_angle << std::endl;
+
+  bool same = (wt1.to_freq_table() == ft1) && (wt2.to_freq_table() == ft2);
+  std::cout << (same ? "Frequency tables match" : "MISMATCH") << std::endl;
+
+  return same ? 0 : 1;
+}
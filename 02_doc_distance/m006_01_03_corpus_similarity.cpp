@@ -0,0 +1,145 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "corpus.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+int main(int argc, char *argv[]) {
+  // The texts must outlive the corpus build; keep either the maps of the
+  // input files or the generated strings.
+  std::vector<std::unique_ptr<mapped_file>> files;
+  std::vector<std::string> generated;
+  std::vector<std::string_view> texts;
+  size_t k = 5;
+
+  if (argc >= 2 && std::string(argv[1]) == "--gen") {
+    srand(A_BIG_PRIME_NUMBER);
+    size_t ndocs = (argc >= 3) ? std::stoul(argv[2]) : 100000;
+    if (argc >= 4)
+      k = std::stoul(argv[3]);
+    generated = generate_corpus(ndocs);
+    for (const auto &g : generated)
+      texts.emplace_back(g);
+  } else if (argc >= 3) {
+    for (int i = 1; i < argc; ++i) {
+      files.emplace_back(new mapped_file(argv[i]));
+      if (!files.back()->valid()) {
+        std::cerr << "Cannot open " << argv[i] << std::endl;
+        return 1;
+      }
+      texts.emplace_back(files.back()->data(), files.back()->size());
+    }
+  } else {
+    std::cerr << "Usage: " << argv[0] << " file1 file2 [file3 ...]"
+              << std::endl;
+    std::cerr << "       " << argv[0] << " --gen [num_docs [k]]" << std::endl;
+    return 1;
+  }
+
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+
+  auto t = std::chrono::high_resolution_clock::now();
+  corpus c;
+  c.add_documents(texts, hw);
+  c.build_index();
+  std::cout << "Documents: " << c.docs.size()
+            << ", vocabulary: " << c.vocab.size()
+            << ", postings: " << c.postings.size() << ", build (ms): "
+            << elapsed_ms(t) << std::endl;
+
+  // Spot check against the angle of the word frequency tables.
+  bool ok = true;
+  for (size_t i = 0; i + 1 < c.docs.size() && i < 100; ++i) {
+    word_freq_table f1, f2;
+    count_word_frequency(texts[i].data(), texts[i].size(), f1);
+    count_word_frequency(texts[i + 1].data(), texts[i + 1].size(), f2);
+    double sim = cosine_similarity(c.docs[i], c.docs[i + 1]);
+    if (std::fabs(std::cos(vector_angle(f1, f2)) - sim) > 1e-9)
+      ok = false;
+  }
+
+  // Every pair is evaluated without pruning; compare on a prefix.
+  const size_t nsub = std::min<size_t>(c.docs.size(), 2000);
+  corpus sub;
+  sub.docs.assign(c.docs.begin(), c.docs.begin() + nsub);
+  sub.vocab = c.vocab;
+  sub.build_index();
+
+  std::cout << std::endl << "Top-" << k << " of " << nsub << " documents"
+            << std::endl;
+  std::cout << "      method   threads    time (ms)" << std::endl;
+  std::vector<std::vector<neighbor_t>> ref;
+  for (bool prune : {false, true}) {
+    t = std::chrono::high_resolution_clock::now();
+    auto r = all_pairs_top_k(sub, k, hw, prune);
+    double ms = elapsed_ms(t);
+    if (!prune)
+      ref = r;
+    bool same = r.size() == ref.size();
+    for (size_t i = 0; same && i < r.size(); ++i) {
+      same = r[i].size() == ref[i].size();
+      for (size_t j = 0; same && j < r[i].size(); ++j)
+        same = r[i][j].doc == ref[i][j].doc && r[i][j].sim == ref[i][j].sim;
+    }
+    ok = ok && same;
+    std::cout.width(12);
+    std::cout << (prune ? "pruned" : "blocked");
+    std::cout.width(10);
+    std::cout << hw;
+    std::cout.width(13);
+    std::cout << ms << std::endl;
+  }
+
+  std::cout << std::endl << "Top-" << k << " of " << c.docs.size()
+            << " documents" << std::endl;
+  std::cout << "      method   threads    time (ms)" << std::endl;
+  std::vector<std::vector<neighbor_t>> top;
+  for (size_t nthreads = 1; nthreads <= hw; nthreads *= 2) {
+    t = std::chrono::high_resolution_clock::now();
+    top = all_pairs_top_k(c, k, nthreads, true);
+    double ms = elapsed_ms(t);
+    std::cout.width(12);
+    std::cout << "pruned";
+    std::cout.width(10);
+    std::cout << nthreads;
+    std::cout.width(13);
+    std::cout << ms << std::endl;
+  }
+
+  // Near-duplicates: nearest neighbour with cosine of at least 0.9.
+  size_t ndup = 0;
+  for (const auto &r : top)
+    ndup += (!r.empty() && r[0].sim >= 0.9);
+  std::cout << std::endl
+            << "Documents with a near-duplicate: " << ndup << std::endl;
+
+  for (size_t i = 0; i < std::min<size_t>(top.size(), 3); ++i) {
+    std::cout << i << ":";
+    for (const auto &nb : top[i])
+      std::cout << " " << nb.doc << " (" << nb.sim << ")";
+    std::cout << std::endl;
+  }
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "corpus.hpp"
+#include "doc_signature.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Near-duplicates: cosine similarity of at least this.
+#define NEAR_DUP_SIM 0.9
+
+#define MINHASH_BANDS 16
+#define MINHASH_ROWS 8
+#define SIMHASH_BANDS 6
+
+// SimHash candidates differing in more bits than this are dropped before
+// the exact comparison.
+#define SIMHASH_MAX_BITS 16
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+template <typename FUNC> void run_threads(size_t nthreads, FUNC func) {
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < nthreads; ++t)
+    workers.emplace_back(func);
+  func();
+  for (auto &w : workers)
+    w.join();
+}
+
+// Nearest neighbour of every document among its LSH candidates, re-ranked
+// with the exact vector_angle. Candidates failing keep(i, j) are skipped.
+// A document without a candidate gets neighbour {i, 0}.
+template <typename KEEP>
+std::vector<neighbor_t>
+lsh_nearest(const corpus &c, const lsh_index &index,
+            const std::vector<uint64_t> &keys, size_t bands, KEEP keep,
+            size_t nthreads, size_t &ncandidates) {
+  const size_t n = c.docs.size();
+  std::vector<neighbor_t> best(n);
+  std::atomic<size_t> next(0), total(0);
+
+  run_threads(nthreads, [&]() {
+    // seen[j] == i + 1 if j is already a candidate of i.
+    std::vector<uint32_t> seen(n, 0);
+    size_t count = 0;
+    for (size_t i; (i = next++) < n;) {
+      neighbor_t nb{static_cast<uint32_t>(i), 0.0};
+      index.candidates(&keys[i * bands], [&](uint32_t j) {
+        if (j == i || seen[j] == i + 1)
+          return;
+        seen[j] = i + 1;
+        if (!keep(i, j))
+          return;
+        ++count;
+        neighbor_t cand{j, std::cos(vector_angle(c.docs[i], c.docs[j]))};
+        if (nb.doc == i || better_neighbor(cand, nb))
+          nb = cand;
+      });
+      best[i] = nb;
+    }
+    total += count;
+  });
+
+  ncandidates = total;
+  return best;
+}
+
+void print_row(const std::string &method, double sign_ms, double index_ms,
+               double query_ms, double cand_per_doc, double recall) {
+  std::cout.width(14);
+  std::cout << method;
+  for (double v : {sign_ms, index_ms, query_ms, cand_per_doc, recall}) {
+    std::cout.width(13);
+    std::cout << v;
+  }
+  std::cout << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::unique_ptr<mapped_file>> files;
+  std::vector<std::string> generated;
+  std::vector<std::string_view> texts;
+
+  if (argc >= 2 && std::string(argv[1]) == "--gen") {
+    srand(A_BIG_PRIME_NUMBER);
+    generated = generate_corpus((argc >= 3) ? std::stoul(argv[2]) : 100000);
+    for (const auto &g : generated)
+      texts.emplace_back(g);
+  } else if (argc >= 3) {
+    for (int i = 1; i < argc; ++i) {
+      files.emplace_back(new mapped_file(argv[i]));
+      if (!files.back()->valid()) {
+        std::cerr << "Cannot open " << argv[i] << std::endl;
+        return 1;
+      }
+      texts.emplace_back(files.back()->data(), files.back()->size());
+    }
+  } else {
+    std::cerr << "Usage: " << argv[0] << " file1 file2 [file3 ...]"
+              << std::endl;
+    std::cerr << "       " << argv[0] << " --gen [num_docs]" << std::endl;
+    return 1;
+  }
+
+  const size_t n = texts.size();
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+
+  corpus c;
+  c.add_documents(texts, hw);
+  c.build_index();
+  std::cout << "Documents: " << n << ", vocabulary: " << c.vocab.size()
+            << ", threads: " << hw << ", near-duplicate cosine >= "
+            << NEAR_DUP_SIM << std::endl;
+
+  // Ground truth: exact nearest neighbours.
+  auto t = std::chrono::high_resolution_clock::now();
+  auto exact = all_pairs_top_k(c, 1, hw, true);
+  double exact_ms = elapsed_ms(t);
+  std::vector<bool> has_dup(n);
+  size_t ndup = 0;
+  for (size_t i = 0; i < n; ++i) {
+    has_dup[i] = !exact[i].empty() && exact[i][0].sim >= NEAR_DUP_SIM;
+    ndup += has_dup[i];
+  }
+  std::cout << "Documents with a near-duplicate: " << ndup << std::endl
+            << std::endl;
+
+  // Signatures, computed from the texts one document at a time.
+  minhash mh(MINHASH_BANDS * MINHASH_ROWS);
+  std::vector<uint32_t> sigs(n * mh.size());
+  std::vector<uint64_t> fps(n);
+  std::atomic<size_t> next(0);
+  t = std::chrono::high_resolution_clock::now();
+  run_threads(hw, [&]() {
+    for (size_t i; (i = next++) < n;) {
+      word_freq_table ft(64);
+      count_word_frequency(texts[i].data(), texts[i].size(), ft);
+      mh.signature(ft, &sigs[i * mh.size()]);
+      fps[i] = simhash::fingerprint(ft);
+    }
+  });
+  double sign_ms = elapsed_ms(t);
+
+  auto recall = [&](const std::vector<neighbor_t> &found) {
+    size_t hit = 0;
+    for (size_t i = 0; i < n; ++i)
+      hit += has_dup[i] && found[i].doc != i && found[i].sim >= NEAR_DUP_SIM;
+    return ndup ? static_cast<double>(hit) / ndup : 1.0;
+  };
+
+  std::cout << "        method    sign (ms)   index (ms)   query (ms)"
+               "     cand/doc       recall"
+            << std::endl;
+  print_row("exact", 0, 0, exact_ms, n - 1.0, 1.0);
+
+  {
+    std::vector<uint64_t> keys(n * MINHASH_BANDS);
+    t = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n; ++i)
+      minhash::band_keys(&sigs[i * mh.size()], MINHASH_BANDS, MINHASH_ROWS,
+                         &keys[i * MINHASH_BANDS]);
+    lsh_index index(MINHASH_BANDS);
+    index.build(keys.data(), n);
+    double index_ms = elapsed_ms(t);
+
+    size_t ncand = 0;
+    t = std::chrono::high_resolution_clock::now();
+    auto found = lsh_nearest(
+        c, index, keys, MINHASH_BANDS, [](size_t, size_t) { return true; },
+        hw, ncand);
+    double query_ms = elapsed_ms(t);
+    print_row("minhash", sign_ms, index_ms, query_ms,
+              static_cast<double>(ncand) / n, recall(found));
+  }
+
+  {
+    std::vector<uint64_t> keys(n * SIMHASH_BANDS);
+    t = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n; ++i)
+      simhash::band_keys(fps[i], SIMHASH_BANDS, &keys[i * SIMHASH_BANDS]);
+    lsh_index index(SIMHASH_BANDS);
+    index.build(keys.data(), n);
+    double index_ms = elapsed_ms(t);
+
+    size_t ncand = 0;
+    t = std::chrono::high_resolution_clock::now();
+    auto found = lsh_nearest(
+        c, index, keys, SIMHASH_BANDS,
+        [&](size_t i, size_t j) {
+          return __builtin_popcountll(fps[i] ^ fps[j]) <= SIMHASH_MAX_BITS;
+        },
+        hw, ncand);
+    double query_ms = elapsed_ms(t);
+    print_row("simhash", sign_ms, index_ms, query_ms,
+              static_cast<double>(ncand) / n, recall(found));
+  }
+
+  // Quality of the estimators on the exact near-duplicate pairs.
+  double jac_err = 0.0, angle_err = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    if (!has_dup[i])
+      continue;
+    const sparse_doc_t &d1 = c.docs[i], &d2 = c.docs[exact[i][0].doc];
+    size_t common = 0;
+    for (size_t x = 0, y = 0; x < d1.terms.size() && y < d2.terms.size();) {
+      if (d1.terms[x] < d2.terms[y]) {
+        ++x;
+      } else if (d2.terms[y] < d1.terms[x]) {
+        ++y;
+      } else {
+        ++common;
+        ++x;
+        ++y;
+      }
+    }
+    double jac = static_cast<double>(common) /
+                 (d1.terms.size() + d2.terms.size() - common);
+    jac_err += std::fabs(
+        minhash::estimate(&sigs[i * mh.size()],
+                          &sigs[exact[i][0].doc * mh.size()], mh.size()) -
+        jac);
+    angle_err += std::fabs(
+        simhash::estimate_angle(fps[i], fps[exact[i][0].doc]) -
+        vector_angle(d1, d2));
+  }
+  if (ndup) {
+    std::cout << std::endl
+              << "Mean error on near-duplicates: jaccard (minhash) "
+              << jac_err / ndup << ", angle (simhash) " << angle_err / ndup
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "doc_distance.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Frequency table of all the partitions.
+freq_table_t to_freq_table(const std::vector<word_freq_table> &parts) {
+  freq_table_t ft;
+  for (const auto &p : parts)
+    p.for_each([&ft](const char *w, size_t len, int count) {
+      ft.emplace(std::string(w, len), count);
+    });
+  return ft;
+}
+
+void print_row(const std::string &method, size_t nthreads, size_t ncores,
+               double ms, double mb, bool same) {
+  std::cout.width(14);
+  std::cout << method;
+  std::cout.width(9);
+  std::cout << nthreads;
+  std::cout.width(13);
+  std::cout << ms;
+  std::cout.width(13);
+  std::cout << mb / (ms / 1000.0);
+  std::cout.width(13);
+  std::cout << mb / (ms / 1000.0) / ncores;
+  std::cout << (same ? "" : "  MISMATCH") << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::string fname;
+  if (argc == 3 && std::string(argv[1]) == "--gen") {
+    srand(A_BIG_PRIME_NUMBER);
+    fname = "word_count_bench.txt";
+    generate_text(fname, std::stoul(argv[2]));
+  } else if (argc == 2) {
+    fname = argv[1];
+  } else {
+    std::cerr << "Usage: " << argv[0] << " file" << std::endl;
+    std::cerr << "       " << argv[0] << " --gen size_in_mb" << std::endl;
+    return 1;
+  }
+
+  mapped_file mf(fname);
+  if (!mf.valid()) {
+    std::cerr << "Cannot open " << fname << std::endl;
+    return 1;
+  }
+  const double mb = mf.size() / (1024.0 * 1024.0);
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+
+  auto t = std::chrono::high_resolution_clock::now();
+  freq_table_t ref;
+  count_file_word_frequency(fname, ref);
+  double ref_ms = elapsed_ms(t);
+
+  std::cout << "Input: " << mf.size() << " bytes, distinct words: "
+            << ref.size() << ", cores: " << hw << std::endl;
+  std::cout << "        method  threads    time (ms)         MB/s"
+               "  MB/s / core"
+            << std::endl;
+  print_row("getline/map", 1, 1, ref_ms, mb, true);
+
+  t = std::chrono::high_resolution_clock::now();
+  word_freq_table single;
+  count_word_frequency(mf.data(), mf.size(), single);
+  double ms = elapsed_ms(t);
+  print_row("mmap/flat", 1, 1, ms, mb, single.to_freq_table() == ref);
+
+  bool ok = true;
+  for (size_t nthreads = 1; nthreads <= std::max<size_t>(hw, 8);
+       nthreads *= 2) {
+    std::vector<word_freq_table> parts;
+    t = std::chrono::high_resolution_clock::now();
+    count_word_frequency_parallel(mf.data(), mf.size(), nthreads, parts);
+    ms = elapsed_ms(t);
+    bool same = to_freq_table(parts) == ref;
+    ok = ok && same;
+    print_row("parallel", nthreads, std::min(nthreads, hw), ms, mb, same);
+  }
+
+  std::cout << (ok ? "Frequency tables match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -6,15 +6,25 @@
 // in the file LICENSE in the source distribution.
 //
 
-#include <functional>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <string>
+#include <vector>
 
 #define WDTH 8
 
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Random inserts and removes of keys below CHECK_KEYS by check_to_vector.
+#define CHECK_OPS 2000
+#define CHECK_KEYS 100
+
 // A vanilla Binary Search Tree.
 // ADT operations insert, remove, find, successor and predecessor are
-// implemented in iterative manner.
+// implemented in iterative manner. So is the inorder traversal, which follows
+// the parent links and thus needs no stack even when the tree is unbalanced.
 class BinarySearchTree {
 
 public:
@@ -27,13 +37,55 @@ public:
     Node(int v) : key(v), parent(nullptr), left(nullptr), right(nullptr) {}
   };
 
-  BinarySearchTree() : root(nullptr) {}
+  // Inorder iterator over the keys. Advancing it is amortized O(1) and needs
+  // O(1) extra space.
+  class const_iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const int *pointer;
+    typedef const int &reference;
+
+    explicit const_iterator(const Node *n = nullptr) : cur(n) {}
+
+    reference operator*() const { return cur->key; }
+    pointer operator->() const { return &cur->key; }
+
+    const Node *node() const { return cur; }
+
+    const_iterator &operator++() {
+      cur = next_inorder(cur);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      cur = next_inorder(cur);
+      return tmp;
+    }
+
+    bool operator==(const const_iterator &o) const { return cur == o.cur; }
+    bool operator!=(const const_iterator &o) const { return cur != o.cur; }
+
+  private:
+    const Node *cur;
+  };
+
+  BinarySearchTree() : root(nullptr), num_nodes(0) {}
 
   bool empty() const { return root == nullptr; }
 
+  size_t size() const { return num_nodes; }
+
+  const_iterator begin() const { return const_iterator(subtree_min(root)); }
+
+  const_iterator end() const { return const_iterator(); }
+
   const Node *insert(int v) {
     if (!root) {
       root = new Node(v);
+      ++num_nodes;
       return root;
     }
 
@@ -55,6 +107,7 @@ public:
     else
       parent->right = n;
     n->parent = parent;
+    ++num_nodes;
     return n;
   }
 
@@ -69,8 +122,20 @@ public:
     return nullptr;
   }
 
-  void inorder_traverse(std::function<void(const Node *)> visit) const {
-    inorder_traverse_subtree(root, visit);
+  // The visitor is a template argument rather than a std::function so that
+  // the call can be inlined.
+  template <typename VISIT> void inorder_traverse(VISIT &&visit) const {
+    for (auto itr = begin(); itr != end(); ++itr)
+      visit(itr.node());
+  }
+
+  // Exports the keys in sorted order into a contiguous buffer.
+  std::vector<int> to_vector() const {
+    std::vector<int> keys(num_nodes);
+    int *out = keys.data();
+    for (const Node *n = subtree_min(root); n; n = next_inorder(n))
+      *out++ = n->key;
+    return keys;
   }
 
   const Node *successor(const Node *n) const {
@@ -169,6 +234,7 @@ public:
       child->parent = par;
     }
     delete cur;
+    --num_nodes;
 
     return true;
   }
@@ -176,16 +242,19 @@ public:
   void print() const { print_recurse(root, 0); }
 
 private:
-  void inorder_traverse_subtree(const Node *n,
-                                std::function<void(const Node *)> visit) const {
-    if (!n)
-      return;
-    inorder_traverse_subtree(n->left, visit);
-    visit(n);
-    inorder_traverse_subtree(n->right, visit);
+  // Inorder successor following the parent links.
+  static const Node *next_inorder(const Node *n) {
+    if (n->right)
+      return subtree_min(n->right);
+
+    // Climb up till n is in the left subtree of the parent.
+    while (n->parent && n->parent->right == n)
+      n = n->parent;
+
+    return n->parent;
   }
 
-  const Node *subtree_max(const Node *n) const {
+  static const Node *subtree_max(const Node *n) {
     if (!n)
       return nullptr;
     while (n->right)
@@ -193,7 +262,7 @@ private:
     return n;
   }
 
-  const Node *subtree_min(const Node *n) const {
+  static const Node *subtree_min(const Node *n) {
     if (!n)
       return nullptr;
     while (n->left)
@@ -217,6 +286,8 @@ private:
   }
 
   Node *root;
+
+  size_t num_nodes;
 };
 
 void PrintKey(const BinarySearchTree::Node *n) { std::cout << n->key << " "; }
@@ -313,7 +384,31 @@ bool menu(BinarySearchTree &bst) {
   return true;
 }
 
+// Checks to_vector() and size() against the keys of the inorder traversal
+// after each of CHECK_OPS random inserts and removes.
+bool check_to_vector() {
+  BinarySearchTree bst;
+  bool ok = true;
+  for (int i = 0; i < CHECK_OPS; ++i) {
+    if (rand() % 3)
+      bst.insert(rand() % CHECK_KEYS);
+    else
+      bst.remove(rand() % CHECK_KEYS);
+
+    std::vector<int> keys;
+    bst.inorder_traverse(
+        [&keys](const BinarySearchTree::Node *n) { keys.push_back(n->key); });
+    ok = ok && bst.to_vector() == keys && bst.size() == keys.size() &&
+         std::is_sorted(keys.begin(), keys.end());
+  }
+  return ok;
+}
+
 int main() {
+  srand(A_BIG_PRIME_NUMBER);
+  std::cout << "to_vector check: " << (check_to_vector() ? "PASS" : "FAIL")
+            << std::endl;
+
   BinarySearchTree bst;
 
   while (menu(bst))
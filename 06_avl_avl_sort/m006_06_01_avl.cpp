@@ -6,13 +6,23 @@
 // in the file LICENSE in the source distribution.
 //
 
-#include <functional>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
+#include <vector>
 
 #define WDTH 16
 
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Random inserts and removes of keys below CHECK_KEYS by check_to_vector.
+#define CHECK_OPS 2000
+#define CHECK_KEYS 100
+
 // AVL Tree, a height balanced BST.
 // ADT operations insert and remove are implemented recursively.
+// Inorder traversal is iterative, following the parent links.
 class AVLTree {
 
 public:
@@ -27,10 +37,51 @@ public:
         : key(v), height(0), parent(nullptr), left(nullptr), right(nullptr) {}
   };
 
-  AVLTree() : root(nullptr) {}
+  // Inorder iterator over the keys. Advancing it is amortized O(1) and needs
+  // O(1) extra space.
+  class const_iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const int *pointer;
+    typedef const int &reference;
+
+    explicit const_iterator(const Node *n = nullptr) : cur(n) {}
+
+    reference operator*() const { return cur->key; }
+    pointer operator->() const { return &cur->key; }
+
+    const Node *node() const { return cur; }
+
+    const_iterator &operator++() {
+      cur = next_inorder(cur);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      cur = next_inorder(cur);
+      return tmp;
+    }
+
+    bool operator==(const const_iterator &o) const { return cur == o.cur; }
+    bool operator!=(const const_iterator &o) const { return cur != o.cur; }
+
+  private:
+    const Node *cur;
+  };
+
+  AVLTree() : root(nullptr), num_nodes(0) {}
 
   bool empty() const { return root == nullptr; }
 
+  size_t size() const { return num_nodes; }
+
+  const_iterator begin() const { return const_iterator(subtree_min(root)); }
+
+  const_iterator end() const { return const_iterator(); }
+
   void print() const { print_recurse(root, 0); }
 
   void insert(int v) {
@@ -103,8 +154,20 @@ public:
       root->parent = nullptr;
   }
 
-  void inorder_traverse(std::function<void(const Node *)> visit) const {
-    inorder_traverse_subtree(root, visit);
+  // The visitor is a template argument rather than a std::function so that
+  // the call can be inlined.
+  template <typename VISIT> void inorder_traverse(VISIT &&visit) const {
+    for (auto itr = begin(); itr != end(); ++itr)
+      visit(itr.node());
+  }
+
+  // Exports the keys in sorted order into a contiguous buffer.
+  std::vector<int> to_vector() const {
+    std::vector<int> keys(num_nodes);
+    int *out = keys.data();
+    for (const Node *n = subtree_min(root); n; n = next_inorder(n))
+      *out++ = n->key;
+    return keys;
   }
 
   // Test code to check parent link sanity after modification.
@@ -113,13 +176,16 @@ public:
   }
 
 private:
-  void inorder_traverse_subtree(const Node *n,
-                                std::function<void(const Node *)> visit) const {
-    if (!n)
-      return;
-    inorder_traverse_subtree(n->left, visit);
-    visit(n);
-    inorder_traverse_subtree(n->right, visit);
+  // Inorder successor following the parent links.
+  static const Node *next_inorder(const Node *n) {
+    if (n->right)
+      return subtree_min(n->right);
+
+    // Climb up till n is in the left subtree of the parent.
+    while (n->parent && n->parent->right == n)
+      n = n->parent;
+
+    return n->parent;
   }
 
   static Node *subtree_max(Node *n) {
@@ -130,7 +196,8 @@ private:
     return n;
   }
 
-  static Node *subtree_min(Node *n) {
+  // NODE is Node or const Node.
+  template <typename NODE> static NODE *subtree_min(NODE *n) {
     if (!n)
       return nullptr;
     while (n->left)
@@ -234,6 +301,7 @@ private:
 
   Node *insert_recurse(Node *n, int v) {
     if (!n) {
+      ++num_nodes;
       return new Node(v);
     }
 
@@ -268,6 +336,7 @@ private:
       } else { // 0 or 1 children.
         auto child = (n->left) ? n->left : n->right;
         delete n;
+        --num_nodes;
         return child;
       }
     } else if (v < n->key) {
@@ -303,6 +372,8 @@ private:
   }
 
   Node *root;
+
+  size_t num_nodes;
 };
 
 void PrintKey(const AVLTree::Node *n) { std::cout << n->key << " "; }
@@ -399,7 +470,32 @@ bool menu(AVLTree &bst) {
   return true;
 }
 
+// Checks to_vector() and size() against the keys of the inorder traversal
+// after each of CHECK_OPS random inserts and removes.
+bool check_to_vector() {
+  AVLTree bst;
+  bool ok = true;
+  for (int i = 0; i < CHECK_OPS; ++i) {
+    if (rand() % 3)
+      bst.insert(rand() % CHECK_KEYS);
+    else
+      bst.remove(rand() % CHECK_KEYS);
+
+    std::vector<int> keys;
+    bst.inorder_traverse(
+        [&keys](const AVLTree::Node *n) { keys.push_back(n->key); });
+    ok = ok && bst.to_vector() == keys && bst.size() == keys.size() &&
+         std::is_sorted(keys.begin(), keys.end()) &&
+         bst.check_parent_links();
+  }
+  return ok;
+}
+
 int main() {
+  srand(A_BIG_PRIME_NUMBER);
+  std::cout << "to_vector check: " << (check_to_vector() ? "PASS" : "FAIL")
+            << std::endl;
+
   AVLTree bst;
 
   while (menu(bst))
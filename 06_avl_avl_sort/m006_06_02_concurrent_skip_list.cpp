@@ -0,0 +1,534 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define MAX_LEVEL 24
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// A concurrent ordered set of integers implemented as a lazy skip list
+// (Herlihy, Lev, Luchangco, Shavit).
+// Reads (find, successor) take no locks: they traverse the list optimistically
+// and validate the 'marked' and 'fully_linked' flags of the node they land on.
+// Writes (insert, remove) lock only the predecessors of the node being
+// linked / unlinked and validate them before modifying the links.
+// Unlinked nodes are not freed immediately as lock-free readers might still
+// be traversing through them. They are retired to a list and freed when the
+// set is destroyed.
+// Keys INT_MIN and INT_MAX are reserved for the sentinel nodes: insert and
+// remove reject them, and find never finds them.
+class ConcurrentSkipList {
+
+public:
+  struct Node {
+    const int key;
+    const int top_level;
+    std::atomic<bool> marked;
+    std::atomic<bool> fully_linked;
+    std::mutex lock;
+    std::atomic<Node *> next[MAX_LEVEL];
+    Node *retired_next;
+
+    Node(int v, int top)
+        : key(v), top_level(top), marked(false), fully_linked(false),
+          retired_next(nullptr) {
+      for (auto &n : next)
+        n.store(nullptr, std::memory_order_relaxed);
+    }
+  };
+
+  ConcurrentSkipList()
+      : head(new Node(INT_MIN, MAX_LEVEL - 1)),
+        tail(new Node(INT_MAX, MAX_LEVEL - 1)), retired(nullptr) {
+    for (auto &n : head->next)
+      n.store(tail, std::memory_order_relaxed);
+    head->fully_linked = true;
+    tail->fully_linked = true;
+  }
+
+  ConcurrentSkipList(const ConcurrentSkipList &) = delete;
+  ConcurrentSkipList &operator=(const ConcurrentSkipList &) = delete;
+
+  ~ConcurrentSkipList() {
+    // Free the nodes still linked at the bottom level.
+    Node *n = head;
+    while (n) {
+      Node *nxt = n->next[0].load(std::memory_order_relaxed);
+      delete n;
+      n = nxt;
+    }
+
+    // Free the retired nodes.
+    n = retired.load(std::memory_order_relaxed);
+    while (n) {
+      Node *nxt = n->retired_next;
+      delete n;
+      n = nxt;
+    }
+  }
+
+  // The keys of the head and tail sentinels.
+  static bool is_reserved(int v) { return v == INT_MIN || v == INT_MAX; }
+
+  bool empty() const { return successor_of_key(INT_MIN) == nullptr; }
+
+  // Returns true if v was added, false if it was already present or is
+  // reserved.
+  bool insert(int v) {
+    if (is_reserved(v))
+      return false;
+    const int top = random_level();
+    Node *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+
+    while (true) {
+      int lfound = find_node(v, preds, succs);
+      if (lfound != -1) {
+        Node *found = succs[lfound];
+        if (!found->marked.load(std::memory_order_acquire)) {
+          // Some other thread is inserting v; wait till it is visible.
+          while (!found->fully_linked.load(std::memory_order_acquire))
+            ;
+          return false;
+        }
+        // Being removed by another thread; retry.
+        continue;
+      }
+
+      // Lock the predecessors and validate that they are still unmarked and
+      // point to the successors observed during the traversal.
+      int highest_locked = -1;
+      bool valid = true;
+      Node *prev_pred = nullptr;
+      for (int l = 0; valid && l <= top; ++l) {
+        Node *pred = preds[l], *succ = succs[l];
+        if (pred != prev_pred) {
+          pred->lock.lock();
+          highest_locked = l;
+          prev_pred = pred;
+        }
+        valid = !pred->marked.load(std::memory_order_acquire) &&
+                !succ->marked.load(std::memory_order_acquire) &&
+                pred->next[l].load(std::memory_order_acquire) == succ;
+      }
+
+      if (!valid) {
+        unlock_preds(preds, highest_locked);
+        continue;
+      }
+
+      // Link bottom up. The node becomes visible to finds only after it is
+      // fully linked.
+      Node *n = new Node(v, top);
+      for (int l = 0; l <= top; ++l)
+        n->next[l].store(succs[l], std::memory_order_relaxed);
+      for (int l = 0; l <= top; ++l)
+        preds[l]->next[l].store(n, std::memory_order_release);
+      n->fully_linked.store(true, std::memory_order_release);
+
+      unlock_preds(preds, highest_locked);
+      return true;
+    }
+  }
+
+  // Returns true if v was removed, false if it was not present or is
+  // reserved.
+  bool remove(int v) {
+    if (is_reserved(v))
+      return false;
+    Node *victim = nullptr;
+    bool is_marked = false;
+    int top = -1;
+    Node *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+
+    while (true) {
+      int lfound = find_node(v, preds, succs);
+      if (lfound != -1)
+        victim = succs[lfound];
+
+      if (!is_marked &&
+          (lfound == -1 ||
+           !victim->fully_linked.load(std::memory_order_acquire) ||
+           victim->top_level != lfound ||
+           victim->marked.load(std::memory_order_acquire)))
+        return false;
+
+      if (!is_marked) {
+        // Logically delete by marking the victim.
+        top = victim->top_level;
+        victim->lock.lock();
+        if (victim->marked.load(std::memory_order_acquire)) {
+          victim->lock.unlock();
+          return false;
+        }
+        victim->marked.store(true, std::memory_order_release);
+        is_marked = true;
+      }
+
+      // Lock the predecessors and validate that they still point to the
+      // victim.
+      int highest_locked = -1;
+      bool valid = true;
+      Node *prev_pred = nullptr;
+      for (int l = 0; valid && l <= top; ++l) {
+        Node *pred = preds[l];
+        if (pred != prev_pred) {
+          pred->lock.lock();
+          highest_locked = l;
+          prev_pred = pred;
+        }
+        valid = !pred->marked.load(std::memory_order_acquire) &&
+                pred->next[l].load(std::memory_order_acquire) == victim;
+      }
+
+      if (!valid) {
+        unlock_preds(preds, highest_locked);
+        continue;
+      }
+
+      // Physically delete by unlinking top down.
+      for (int l = top; l >= 0; --l)
+        preds[l]->next[l].store(
+            victim->next[l].load(std::memory_order_acquire),
+            std::memory_order_release);
+
+      victim->lock.unlock();
+      unlock_preds(preds, highest_locked);
+      retire(victim);
+      return true;
+    }
+  }
+
+  // Wait-free membership test.
+  const Node *find(int v) const {
+    if (is_reserved(v))
+      return nullptr;
+    Node *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+    int lfound = find_node(v, preds, succs);
+    if (lfound == -1)
+      return nullptr;
+    Node *n = succs[lfound];
+    return (n->fully_linked.load(std::memory_order_acquire) &&
+            !n->marked.load(std::memory_order_acquire))
+               ? n
+               : nullptr;
+  }
+
+  // Smallest key present in the set that is larger than the key of n.
+  // Nodes are never freed while the set is alive, so n may have been removed
+  // concurrently.
+  const Node *successor(const Node *n) const {
+    return (n) ? successor_of_key(n->key) : nullptr;
+  }
+
+  // Smallest key present in the set that is larger than v.
+  const Node *successor_of_key(int v) const {
+    Node *pred = head;
+    Node *cur = nullptr;
+    for (int l = MAX_LEVEL - 1; l >= 0; --l) {
+      cur = pred->next[l].load(std::memory_order_acquire);
+      while (cur != tail && cur->key <= v) {
+        pred = cur;
+        cur = pred->next[l].load(std::memory_order_acquire);
+      }
+    }
+
+    // Skip over the nodes being inserted or removed.
+    while (cur != tail && (cur->marked.load(std::memory_order_acquire) ||
+                           !cur->fully_linked.load(std::memory_order_acquire)))
+      cur = cur->next[0].load(std::memory_order_acquire);
+
+    return (cur != tail) ? cur : nullptr;
+  }
+
+  // Not thread safe: Test code to check the bottom level is sorted and
+  // every upper level is a subsequence of the level below.
+  bool check_levels() const {
+    for (int l = 0; l < MAX_LEVEL; ++l) {
+      const Node *n = head->next[l].load();
+      int prev = INT_MIN;
+      while (n != tail) {
+        if (n->key <= prev || n->top_level < l) {
+          std::cout << "Level " << l << " disorder at: " << n->key
+                    << std::endl;
+          return false;
+        }
+        prev = n->key;
+        n = n->next[l].load();
+      }
+    }
+    return true;
+  }
+
+private:
+  // Fills up the predecessors and the successors of v at each level.
+  // Returns the highest level at which v is found, -1 if not found.
+  int find_node(int v, Node **preds, Node **succs) const {
+    int lfound = -1;
+    Node *pred = head;
+    for (int l = MAX_LEVEL - 1; l >= 0; --l) {
+      Node *cur = pred->next[l].load(std::memory_order_acquire);
+      while (v > cur->key) {
+        pred = cur;
+        cur = pred->next[l].load(std::memory_order_acquire);
+      }
+      if (lfound == -1 && v == cur->key)
+        lfound = l;
+      preds[l] = pred;
+      succs[l] = cur;
+    }
+    return lfound;
+  }
+
+  // Predecessors at consecutive levels may be the same node, which is locked
+  // only once.
+  static void unlock_preds(Node **preds, int highest_locked) {
+    for (int l = 0; l <= highest_locked; ++l) {
+      if (l == 0 || preds[l] != preds[l - 1])
+        preds[l]->lock.unlock();
+    }
+  }
+
+  // Lock-free push to the retired list.
+  void retire(Node *n) {
+    Node *old = retired.load(std::memory_order_relaxed);
+    do {
+      n->retired_next = old;
+    } while (!retired.compare_exchange_weak(old, n, std::memory_order_release,
+                                            std::memory_order_relaxed));
+  }
+
+  // Geometric distribution with p = 1/2 using a per-thread xorshift
+  // generator; avoids contention on the shared state of rand().
+  static int random_level() {
+    thread_local uint64_t state =
+        0x9E3779B97F4A7C15ULL ^
+        (static_cast<uint64_t>(
+             std::hash<std::thread::id>{}(std::this_thread::get_id()))
+         << 1);
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int level = 0;
+    uint64_t bits = state;
+    while ((bits & 1) && level < MAX_LEVEL - 1) {
+      ++level;
+      bits >>= 1;
+    }
+    return level;
+  }
+
+  Node *const head;
+  Node *const tail;
+  std::atomic<Node *> retired;
+};
+
+// Baseline: a red-black tree shared through a readers-writer lock.
+class CoarseLockedSet {
+public:
+  bool insert(int v) {
+    std::unique_lock<std::shared_mutex> lk(mtx);
+    return s.insert(v).second;
+  }
+
+  bool remove(int v) {
+    std::unique_lock<std::shared_mutex> lk(mtx);
+    return s.erase(v) > 0;
+  }
+
+  bool find(int v) const {
+    std::shared_lock<std::shared_mutex> lk(mtx);
+    return s.find(v) != s.end();
+  }
+
+  bool successor_of_key(int v, int &res) const {
+    std::shared_lock<std::shared_mutex> lk(mtx);
+    auto itr = s.upper_bound(v);
+    if (itr == s.end())
+      return false;
+    res = *itr;
+    return true;
+  }
+
+private:
+  mutable std::shared_mutex mtx;
+  std::set<int> s;
+};
+
+// Uniform adapters for the benchmark.
+bool set_insert(ConcurrentSkipList &s, int v) { return s.insert(v); }
+bool set_remove(ConcurrentSkipList &s, int v) { return s.remove(v); }
+bool set_find(const ConcurrentSkipList &s, int v) { return s.find(v); }
+bool set_successor(const ConcurrentSkipList &s, int v) {
+  return s.successor_of_key(v);
+}
+
+bool set_insert(CoarseLockedSet &s, int v) { return s.insert(v); }
+bool set_remove(CoarseLockedSet &s, int v) { return s.remove(v); }
+bool set_find(const CoarseLockedSet &s, int v) { return s.find(v); }
+bool set_successor(const CoarseLockedSet &s, int v) {
+  int res;
+  return s.successor_of_key(v, res);
+}
+
+// Single threaded comparison against std::set.
+bool run_sanity_test(size_t nops, int key_range) {
+  ConcurrentSkipList csl;
+  std::set<int> ref;
+  srand(A_BIG_PRIME_NUMBER);
+
+  for (size_t i = 0; i < nops; ++i) {
+    int key = rand() % key_range;
+    switch (rand() % 4) {
+    case 0:
+      if (csl.insert(key) != ref.insert(key).second)
+        return false;
+      break;
+    case 1:
+      if (csl.remove(key) != (ref.erase(key) > 0))
+        return false;
+      break;
+    case 2:
+      if ((csl.find(key) != nullptr) != (ref.find(key) != ref.end()))
+        return false;
+      break;
+    default: {
+      auto n = csl.successor_of_key(key);
+      auto itr = ref.upper_bound(key);
+      if ((n == nullptr) != (itr == ref.end()) || (n && n->key != *itr))
+        return false;
+    } break;
+    }
+  }
+
+  // The sentinel keys are rejected and leave the list intact.
+  for (int key : {INT_MIN, INT_MAX})
+    if (csl.insert(key) || csl.remove(key) || csl.find(key))
+      return false;
+
+  // Inorder walk of the bottom level must match std::set.
+  auto itr = ref.begin();
+  for (auto n = csl.successor_of_key(INT_MIN); n; n = csl.successor(n), ++itr)
+    if (itr == ref.end() || n->key != *itr)
+      return false;
+
+  return itr == ref.end() && csl.check_levels();
+}
+
+// Threads insert disjoint key sets concurrently, then remove half of them
+// concurrently. Everything inserted and not removed must be present.
+bool run_concurrent_test(size_t nthreads, int keys_per_thread) {
+  ConcurrentSkipList csl;
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < nthreads; ++t)
+    workers.emplace_back([&csl, t, nthreads, keys_per_thread]() {
+      for (int k = 0; k < keys_per_thread; ++k)
+        csl.insert(static_cast<int>(k * nthreads + t));
+      for (int k = 0; k < keys_per_thread; k += 2)
+        csl.remove(static_cast<int>(k * nthreads + t));
+    });
+  for (auto &w : workers)
+    w.join();
+
+  for (int k = 0; k < keys_per_thread; ++k)
+    for (size_t t = 0; t < nthreads; ++t)
+      if ((csl.find(static_cast<int>(k * nthreads + t)) != nullptr) !=
+          (k % 2 == 1))
+        return false;
+
+  return csl.check_levels();
+}
+
+// Every thread performs nops operations on random keys. read_pct percent of
+// the operations are reads (find and successor in equal parts), the rest are
+// writes (insert and remove in equal parts).
+// Returns throughput in million operations per second.
+template <typename SET>
+double run_benchmark(SET &s, size_t nthreads, size_t nops, int read_pct,
+                     int key_range) {
+  // Pre-fill half of the key range.
+  for (int k = 0; k < key_range; k += 2)
+    set_insert(s, k);
+
+  std::atomic<size_t> hits(0);
+  std::vector<std::thread> workers;
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (size_t t = 0; t < nthreads; ++t)
+    workers.emplace_back([&s, &hits, t, nops, read_pct, key_range]() {
+      uint64_t state = 0x2545F4914F6CDD1DULL * (t + 1);
+      size_t found = 0;
+      for (size_t i = 0; i < nops; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int key = static_cast<int>(state % key_range);
+        int dice = static_cast<int>((state >> 32) % 200);
+        if (dice < 2 * read_pct)
+          found += (dice & 1) ? set_find(s, key) : set_successor(s, key);
+        else
+          found += (dice & 1) ? set_insert(s, key) : set_remove(s, key);
+      }
+      hits += found;
+    });
+  for (auto &w : workers)
+    w.join();
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  double ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+  return (nthreads * nops) / (ms * 1000.0);
+}
+
+int main() {
+  std::cout << "Sanity test: "
+            << (run_sanity_test(200000, 1000) ? "PASS" : "FAIL") << std::endl;
+  std::cout << "Concurrent test: "
+            << (run_concurrent_test(4, 20000) ? "PASS" : "FAIL") << std::endl
+            << std::endl;
+
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<size_t> thread_counts = {1, 2, 4};
+  if (hw > 4)
+    thread_counts.push_back(hw);
+
+  const size_t NOPS = 200000; // Per thread.
+  const int KEY_RANGE = 1 << 16;
+
+  std::cout << "Throughput (Mops/s), key range: " << KEY_RANGE
+            << ", ops per thread: " << NOPS << std::endl;
+  std::cout << "threads  read%  skip-list  rwlock-set" << std::endl;
+  for (auto nthreads : thread_counts) {
+    for (int read_pct : {100, 90, 50, 10}) {
+      ConcurrentSkipList csl;
+      CoarseLockedSet cls;
+      auto csl_mops = run_benchmark(csl, nthreads, NOPS, read_pct, KEY_RANGE);
+      auto cls_mops = run_benchmark(cls, nthreads, NOPS, read_pct, KEY_RANGE);
+      std::cout.width(7);
+      std::cout << nthreads;
+      std::cout.width(7);
+      std::cout << read_pct;
+      std::cout.width(11);
+      std::cout << csl_mops;
+      std::cout.width(12);
+      std::cout << cls_mops << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,456 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "heap_sort.hpp"
+#include "merge_sort.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+#define NIL UINT32_MAX
+
+// AVL tree used for sorting.
+// Nodes are allocated from a contiguous arena and linked by arena index
+// rather than by pointer: one allocation for the whole sort, smaller nodes
+// and better locality than one new per key.
+// Elements that compare equal (neither less than the other) take one tree
+// node: the first is kept in the node, the later ones are chained to it in
+// insertion order in arena slots outside the tree. Each element is stored,
+// so sorting records by a key keeps the records, and the sort is stable.
+// A count per node would be smaller but would write back copies of the
+// first record for all the equal ones; the chain still keeps duplicates
+// out of the tree, whose height depends only on the distinct keys.
+template <typename T, typename CMP = std::less<T>> class AVLSortTree {
+
+public:
+  struct Node {
+    T key;
+    uint32_t equal; // Next element equal to key, NIL for the last.
+    uint32_t last;  // Last element of the chain; tree nodes only.
+    int32_t height;
+    uint32_t left;
+    uint32_t right;
+  };
+
+  explicit AVLSortTree(size_t capacity, CMP c = CMP())
+      : root(NIL), nodes(0), cmp(c) {
+    arena.reserve(capacity);
+  }
+
+  // Number of distinct keys.
+  size_t distinct() const { return nodes; }
+
+  void insert(const T &v) { root = insert_recurse(root, v); }
+
+  // Builds a perfectly balanced tree from a sorted range in O(n), replacing
+  // the current contents.
+  void build_sorted(const T *sorted, size_t n) {
+    arena.clear();
+    std::vector<uint32_t> ids; // Tree nodes in sorted order.
+    for (size_t i = 0; i < n; ++i) {
+      const uint32_t id = new_node(sorted[i]);
+      if (!ids.empty() && !cmp(arena[ids.back()].key, sorted[i]))
+        append_equal(ids.back(), id);
+      else
+        ids.push_back(id);
+    }
+    nodes = ids.size();
+    root = build_balanced(ids, 0, static_cast<int64_t>(ids.size()) - 1);
+  }
+
+  // Writes the elements inserted, in sorted order, equal ones in insertion
+  // order. Returns the number of elements written.
+  size_t export_sorted(T *out) const {
+    // Explicit stack; an AVL tree is never deeper than 1.44 * lg(n).
+    uint32_t stack[96];
+    int top = 0;
+    size_t k = 0;
+    uint32_t cur = root;
+    while (cur != NIL || top > 0) {
+      while (cur != NIL) {
+        stack[top++] = cur;
+        cur = arena[cur].left;
+      }
+      cur = stack[--top];
+      for (uint32_t e = cur; e != NIL; e = arena[e].equal)
+        out[k++] = arena[e].key;
+      cur = arena[cur].right;
+    }
+    return k;
+  }
+
+  int height() const { return get_node_height(root); }
+
+private:
+  uint32_t new_node(const T &v) {
+    const uint32_t id = static_cast<uint32_t>(arena.size());
+    arena.push_back(Node{v, NIL, id, 0, NIL, NIL});
+    return id;
+  }
+
+  // Chains element e after the elements equal to tree node n.
+  void append_equal(uint32_t n, uint32_t e) {
+    arena[arena[n].last].equal = e;
+    arena[n].last = e;
+  }
+
+  int get_node_height(uint32_t n) const {
+    // NIL nodes have height of -1, this simplifies height calculation.
+    return (n != NIL) ? arena[n].height : -1;
+  }
+
+  // Difference between height of the right and the left child.
+  int get_node_height_diff(uint32_t n) const {
+    return get_node_height(arena[n].right) - get_node_height(arena[n].left);
+  }
+
+  void adjust_height(uint32_t n) {
+    arena[n].height = std::max(get_node_height(arena[n].left),
+                               get_node_height(arena[n].right)) +
+                      1;
+  }
+
+  uint32_t left_rotate(uint32_t x) {
+    uint32_t y = arena[x].right;
+    arena[x].right = arena[y].left;
+    arena[y].left = x;
+    adjust_height(x);
+    adjust_height(y);
+    return y;
+  }
+
+  uint32_t right_rotate(uint32_t x) {
+    uint32_t y = arena[x].left;
+    arena[x].left = arena[y].right;
+    arena[y].right = x;
+    adjust_height(x);
+    adjust_height(y);
+    return y;
+  }
+
+  uint32_t fix_height_imbalance(uint32_t x) {
+    int hdiff = get_node_height_diff(x);
+    if (hdiff > 1) { // Right imbalance
+      if (get_node_height_diff(arena[x].right) < 0)
+        arena[x].right = right_rotate(arena[x].right);
+      return left_rotate(x);
+    } else if (hdiff < -1) { // Left imbalance
+      if (get_node_height_diff(arena[x].left) > 0)
+        arena[x].left = left_rotate(arena[x].left);
+      return right_rotate(x);
+    }
+    return x;
+  }
+
+  uint32_t insert_recurse(uint32_t n, const T &v) {
+    if (n == NIL) {
+      ++nodes;
+      return new_node(v);
+    }
+
+    // Recurse before touching arena[n]: the recursion may grow the arena.
+    if (cmp(v, arena[n].key)) {
+      uint32_t l = insert_recurse(arena[n].left, v);
+      arena[n].left = l;
+    } else if (cmp(arena[n].key, v)) {
+      uint32_t r = insert_recurse(arena[n].right, v);
+      arena[n].right = r;
+    } else {
+      // Duplicate: no structural change.
+      append_equal(n, new_node(v));
+      return n;
+    }
+
+    adjust_height(n);
+    return fix_height_imbalance(n);
+  }
+
+  uint32_t build_balanced(const std::vector<uint32_t> &ids, int64_t low,
+                          int64_t high) {
+    if (low > high)
+      return NIL;
+    int64_t mid = (low + high) / 2;
+    const uint32_t n = ids[mid];
+    arena[n].left = build_balanced(ids, low, mid - 1);
+    arena[n].right = build_balanced(ids, mid + 1, high);
+    adjust_height(n);
+    return n;
+  }
+
+  std::vector<Node> arena;
+  uint32_t root;
+  size_t nodes; // Tree nodes, one per distinct key.
+  CMP cmp;
+};
+
+// Stable sort by inserting each element into an AVL tree and exporting the
+// elements inorder. O(n lg d) for d distinct keys.
+template <typename T, typename CMP = std::less<T>>
+void avl_tree_sort(T *arr, size_t n, CMP cmp = CMP()) {
+  AVLSortTree<T, CMP> tree(n, cmp);
+  for (size_t i = 0; i < n; ++i)
+    tree.insert(arr[i]);
+  tree.export_sorted(arr);
+}
+
+// Adaptive tree sort:
+// The input is first split into maximal presorted (non-descending or
+// non-ascending) runs, a run's direction set by the first element unequal
+// to its first. Non-ascending runs are reversed in place, then each group of
+// equal elements in them is reversed back, so that equal elements keep
+// their order; the merges are stable too, so the sort is stable.
+// - A single run is already sorted; the tree is built from it in O(n).
+// - A few runs (r <= lg n) are merged pairwise in O(n lg r) and the tree is
+//   then built in O(n).
+// - Otherwise fall back to plain insertion.
+template <typename T, typename CMP = std::less<T>>
+void avl_tree_sort_adaptive(T *arr, size_t n, CMP cmp = CMP()) {
+  if (n < 2)
+    return;
+
+  // Run boundaries: run k is [runs[k], runs[k + 1]).
+  std::vector<size_t> runs;
+  size_t lg_n = 0;
+  for (size_t m = n; m >>= 1;)
+    ++lg_n;
+
+  for (size_t i = 0; i < n && runs.size() <= lg_n;) {
+    runs.push_back(i);
+    size_t j = i + 1;
+    while (j < n && !cmp(arr[i], arr[j]) && !cmp(arr[j], arr[i]))
+      ++j;
+    if (j < n && cmp(arr[j], arr[i])) {
+      // Non-ascending run.
+      while (j < n && !cmp(arr[j - 1], arr[j]))
+        ++j;
+      std::reverse(arr + i, arr + j);
+      for (size_t g = i; g < j;) {
+        size_t h = g + 1;
+        while (h < j && !cmp(arr[g], arr[h]))
+          ++h;
+        std::reverse(arr + g, arr + h);
+        g = h;
+      }
+    } else {
+      while (j < n && !cmp(arr[j], arr[j - 1]))
+        ++j;
+    }
+    i = j;
+  }
+
+  AVLSortTree<T, CMP> tree(n, cmp);
+
+  if (runs.size() > lg_n) {
+    // Too many runs; not worth merging.
+    for (size_t i = 0; i < n; ++i)
+      tree.insert(arr[i]);
+    tree.export_sorted(arr);
+    return;
+  }
+
+  runs.push_back(n);
+  if (runs.size() > 2) {
+    // Merge adjacent runs pairwise till one run is left.
+    std::vector<T> aux(n);
+    T *cur = arr, *nxt = aux.data();
+    while (runs.size() > 2) {
+      std::vector<size_t> merged;
+      size_t k = 0;
+      for (; k + 2 < runs.size(); k += 2) {
+        std::merge(cur + runs[k], cur + runs[k + 1], cur + runs[k + 1],
+                   cur + runs[k + 2], nxt + runs[k], cmp);
+        merged.push_back(runs[k]);
+      }
+      if (k + 1 < runs.size()) {
+        // Odd run out.
+        std::copy(cur + runs[k], cur + runs[k + 1], nxt + runs[k]);
+        merged.push_back(runs[k]);
+      }
+      merged.push_back(n);
+      runs.swap(merged);
+      std::swap(cur, nxt);
+    }
+    if (cur != arr)
+      std::copy(cur, cur + n, arr);
+  }
+
+  tree.build_sorted(arr, n);
+  tree.export_sorted(arr);
+}
+
+// Input distributions for the benchmark.
+enum input_kind_t {
+  RANDOM,
+  FEW_DISTINCT,
+  SORTED,
+  REVERSED,
+  REVERSED_DUPLICATES,
+  EIGHT_RUNS
+};
+
+const char *input_kind_name(input_kind_t k) {
+  switch (k) {
+  case RANDOM:
+    return "random";
+  case FEW_DISTINCT:
+    return "few-distinct";
+  case SORTED:
+    return "sorted";
+  case REVERSED:
+    return "reversed";
+  case REVERSED_DUPLICATES:
+    return "reversed-dups";
+  case EIGHT_RUNS:
+    return "8-runs";
+  default:
+    break;
+  }
+  return "?";
+}
+
+std::vector<int> make_input(input_kind_t kind, size_t n) {
+  std::vector<int> v(n);
+  for (auto &x : v)
+    x = rand();
+
+  switch (kind) {
+  case FEW_DISTINCT:
+    for (auto &x : v)
+      x %= 100;
+    break;
+  case SORTED:
+    std::sort(v.begin(), v.end());
+    break;
+  case REVERSED:
+    std::sort(v.begin(), v.end(), std::greater<int>());
+    break;
+  case REVERSED_DUPLICATES:
+    for (auto &x : v)
+      x %= 1000;
+    std::sort(v.begin(), v.end(), std::greater<int>());
+    break;
+  case EIGHT_RUNS:
+    for (size_t r = 0; r < 8; ++r)
+      std::sort(v.begin() + r * n / 8, v.begin() + (r + 1) * n / 8);
+    break;
+  case RANDOM:
+  default:
+    break;
+  }
+  return v;
+}
+
+// Times sorter on a copy of the input and verifies the result.
+template <typename SORTER>
+double time_sort(const std::vector<int> &input, const std::vector<int> &ref,
+                 SORTER sorter, bool &ok) {
+  std::vector<int> v(input);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  sorter(v);
+  auto t2 = std::chrono::high_resolution_clock::now();
+  ok = ok && (v == ref);
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  // Small demo.
+  int arr[] = {90, 20, 10, 30, 60, 50, 20, 90};
+  avl_tree_sort(arr, sizeof(arr) / sizeof(arr[0]));
+  for (auto &i : arr)
+    std::cout << i << " ";
+  std::cout << std::endl << std::endl;
+
+  // Records sorted by key only must come out as std::stable_sort has them.
+  std::vector<std::pair<int, int>> records(10000);
+  for (size_t i = 0; i < records.size(); ++i)
+    records[i] = {rand() % 100, static_cast<int>(i)};
+  auto by_key = [](const std::pair<int, int> &a,
+                   const std::pair<int, int> &b) { return a.first < b.first; };
+  auto stable = records;
+  std::stable_sort(stable.begin(), stable.end(), by_key);
+  auto tree_sorted = records, adaptive_sorted = records;
+  avl_tree_sort(tree_sorted.data(), tree_sorted.size(), by_key);
+  // Two runs, merged, with equal keys across them.
+  std::stable_sort(adaptive_sorted.begin(), adaptive_sorted.begin() + 5000,
+                   by_key);
+  std::stable_sort(adaptive_sorted.begin() + 5000, adaptive_sorted.end(),
+                   by_key);
+  auto adaptive_stable = adaptive_sorted;
+  std::stable_sort(adaptive_stable.begin(), adaptive_stable.end(), by_key);
+  avl_tree_sort_adaptive(adaptive_sorted.data(), adaptive_sorted.size(),
+                         by_key);
+  // One non-ascending run of equal keys in index order.
+  auto reversed_sorted = records;
+  std::stable_sort(
+      reversed_sorted.begin(), reversed_sorted.end(),
+      [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+        return a.first > b.first;
+      });
+  auto reversed_stable = reversed_sorted;
+  std::stable_sort(reversed_stable.begin(), reversed_stable.end(), by_key);
+  avl_tree_sort_adaptive(reversed_sorted.data(), reversed_sorted.size(),
+                         by_key);
+  std::cout << "Records by key: "
+            << (tree_sorted == stable && adaptive_sorted == adaptive_stable &&
+                        reversed_sorted == reversed_stable
+                    ? "PASS"
+                    : "FAIL")
+            << std::endl
+            << std::endl;
+
+  std::cout << "Time (ms)" << std::endl;
+  std::cout << "       n         input      merge       heap        avl  "
+               "avl-adapt"
+            << std::endl;
+  for (size_t n : {10000, 100000, 1000000}) {
+    for (auto kind : {RANDOM, FEW_DISTINCT, SORTED, REVERSED,
+                      REVERSED_DUPLICATES, EIGHT_RUNS}) {
+      auto input = make_input(kind, n);
+      auto ref = input;
+      std::sort(ref.begin(), ref.end());
+
+      bool ok = true;
+      auto t_merge = time_sort(input, ref, [](std::vector<int> &v) {
+        two_way_merge_sort(v.data(), static_cast<int>(v.size()));
+      }, ok);
+      auto t_heap = time_sort(input, ref, [](std::vector<int> &v) {
+        heap_store h = {std::vector<int>(), static_cast<int>(v.size())};
+        h.v.swap(v);
+        heap_sort(h, std::greater<int>());
+        v.swap(h.v);
+      }, ok);
+      auto t_avl = time_sort(input, ref, [](std::vector<int> &v) {
+        avl_tree_sort(v.data(), v.size());
+      }, ok);
+      auto t_adapt = time_sort(input, ref, [](std::vector<int> &v) {
+        avl_tree_sort_adaptive(v.data(), v.size());
+      }, ok);
+
+      std::cout.width(8);
+      std::cout << n;
+      std::cout.width(14);
+      std::cout << input_kind_name(kind);
+      for (auto t : {t_merge, t_heap, t_avl, t_adapt}) {
+        std::cout.width(11);
+        std::cout << t;
+      }
+      std::cout << (ok ? "" : "  MISMATCH") << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,343 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#define NCVALS 13
+
+// Represent a card using a card number (1 - 13) and a
+// card type (CLUB, DIAMOND, HEARTS, SPADE).
+enum card_type_t { CLUB, DIAMOND, HEARTS, SPADE, NCTYPES = 4 };
+typedef std::pair<int, card_type_t> card_t;
+
+inline std::ostream &operator<<(std::ostream &os, const card_t &c) {
+  const char *card_vals = "0A23456789TJQK";
+  const char *card_types = "CDHS";
+  os << "[" << ((c.first >= 1 && c.first <= NCVALS) ? card_vals[c.first] : '#')
+     << ((c.second >= CLUB && c.second < NCTYPES) ? card_types[c.second] : 'X')
+     << "]";
+
+  return os;
+}
+
+inline size_t total_card_value(const card_t *deck,
+                               const std::list<size_t> &cards,
+                               bool is_ace_11) {
+  size_t sum = 0;
+  for (auto c : cards) {
+    if (deck[c].first == 1) // Ace: Either 1 or 11.
+      sum += ((is_ace_11) ? 11 : 1);
+    else if (deck[c].first > 1 && deck[c].first < 11)
+      sum += deck[c].first;
+    else // Picture Cards.
+      sum += 10;
+  }
+
+  return sum;
+}
+
+inline size_t best_total_card_value(const card_t *deck,
+                                    const std::list<size_t> &cards) {
+  auto value = total_card_value(deck, cards, true);
+  return (value > 21) ? total_card_value(deck, cards, false) : value;
+}
+
+typedef std::pair<size_t /* cards_played */, int /* player_income */>
+    round_res_t;
+
+// Executes one round of play, starting with the card at index idx in the deck
+// and returns the number of cards played and the income of the player. Player
+// income returned =
+//   1: player wins.
+//  -1: dealer wins.
+//   0: tie.
+inline round_res_t round_outcome(const card_t *deck, size_t DECKSZ,
+                                 size_t idx, size_t hits,
+                                 bool verbose = false) {
+  size_t cards_played = 0;
+  std::list<size_t> dealer_cards, player_cards;
+
+  // Deal: Distribute one-one card each to player and dealer twice.
+  for (auto i = 0; i < 2; ++i) {
+    if (idx + cards_played < DECKSZ)
+      player_cards.push_back(idx + cards_played++);
+    else
+      break;
+    if (idx + cards_played < DECKSZ)
+      dealer_cards.push_back(idx + cards_played++);
+    else
+      break;
+  }
+
+  // Player's hits:
+  for (size_t h = 0; h < hits; ++h) {
+    // If player has bust, stop.
+    if (best_total_card_value(deck, player_cards) > 21)
+      break;
+
+    if (idx + cards_played < DECKSZ)
+      player_cards.push_back(idx + cards_played++);
+    else
+      break;
+  }
+
+  auto player_value = best_total_card_value(deck, player_cards);
+
+  int player_income = 0;
+
+  if (player_value > 21) // Player bust
+    player_income = -1;
+  else {
+    // Dealer's hits: Keep hitting till value < 17
+    while (total_card_value(deck, dealer_cards, true) < 17) {
+      // If dealer has won, stop.
+      if (best_total_card_value(deck, dealer_cards) > player_value)
+        break;
+
+      if (idx + cards_played < DECKSZ)
+        dealer_cards.push_back(idx + cards_played++);
+      else
+        break;
+    }
+
+    auto dealer_value = best_total_card_value(deck, dealer_cards);
+
+    if (dealer_value > 21) // Dealer bust
+      player_income = 1;
+    else if (player_value > dealer_value)
+      player_income = 1;
+    else if (player_value < dealer_value)
+      player_income = -1;
+  }
+
+  if (verbose) {
+    std::cout << std::endl << "Player Cards: ";
+    for (auto c : player_cards)
+      std::cout << deck[c];
+    std::cout << std::endl << "Player Value: " << player_value << std::endl;
+
+    std::cout << "Dealer Cards: ";
+    for (auto c : dealer_cards)
+      std::cout << deck[c];
+    std::cout << std::endl
+              << "Dealer Value: " << best_total_card_value(deck, dealer_cards)
+              << std::endl;
+    std::cout << "Player Earnings: " << player_income << std::endl;
+  }
+
+  return std::make_pair(cards_played, player_income);
+}
+
+// Fills best_hit[0, DECKSZ] and returns the maximum profit over the deck.
+// For every (i, h) pair round_outcome rebuilds the hands and re-walks them
+// after every hit: O(n^3).
+inline int blackjack_dp_naive(const card_t *deck, size_t DECKSZ,
+                              std::vector<size_t> &best_hit) {
+  // DP Table: Stores the maximum possible profit possible if a round starts at
+  // the same index in deck.
+  std::vector<int> max_profit(DECKSZ + 1);
+  best_hit.assign(DECKSZ + 1, 0);
+
+  // Seed value: If no card left in deck, no profit or loss.
+  max_profit[DECKSZ] = 0;
+
+  for (ssize_t i = DECKSZ - 1; i >= 0; --i) {
+    max_profit[i] = -1 * DECKSZ; // Min possible profit.
+    best_hit[i] = 0;
+    // Save what number of hits 'h' give the maximum profit.
+    for (size_t h = 0; h < DECKSZ - i; ++h) {
+      auto rout = round_outcome(deck, DECKSZ, i, h);
+      if (rout.second + max_profit[i + rout.first] > max_profit[i]) {
+        max_profit[i] = rout.second + max_profit[i + rout.first];
+        best_hit[i] = h;
+      }
+    }
+  }
+
+  return max_profit[0];
+}
+
+// Most cards a hand can hold. The player stops hitting once bust, so holds
+// at most 21 aces and one more card; the dealer stops at 17.
+#define MAX_HAND_CARDS 24
+
+// Points of a card, counting an ace as 1.
+inline size_t card_points(const card_t &c) {
+  if (c.first == 1)
+    return 1;
+  return (c.first > 1 && c.first < 11) ? c.first : 10; // Picture Cards: 10.
+}
+
+// Hand evaluated incrementally: a running total with every ace counted as 1
+// and the number of aces. The deck indices of the cards are kept in a fixed
+// array, so a hand never allocates.
+struct hand_t {
+  size_t low;  // Total counting every ace as 1.
+  size_t aces; // Number of aces.
+  size_t ncards;
+  size_t cards[MAX_HAND_CARDS];
+
+  hand_t() : low(0), aces(0), ncards(0) {}
+
+  void add(const card_t *deck, size_t idx) {
+    low += card_points(deck[idx]);
+    aces += (deck[idx].first == 1);
+    if (ncards < MAX_HAND_CARDS)
+      cards[ncards++] = idx;
+  }
+
+  // total_card_value with is_ace_11.
+  size_t value_ace_11() const { return low + 10 * aces; }
+
+  // best_total_card_value.
+  size_t best() const {
+    const size_t v = value_ace_11();
+    return (v > 21) ? low : v;
+  }
+};
+
+// Outcomes of the rounds starting at deck index idx, for 0, 1, 2, ... hits
+// in turn. One more hit adds at most one card to the player's hand; only
+// the dealer's play, at most 17 cards, is redone for every outcome.
+// Gives the same results as round_outcome.
+class round_evaluator {
+private:
+  const card_t *deck;
+  const size_t DECKSZ;
+  const size_t idx;
+  size_t cards_played; // Dealt and hit by the player so far.
+  hand_t player, dealer;
+
+public:
+  round_evaluator(const card_t *_deck, size_t _DECKSZ, size_t _idx)
+      : deck(_deck), DECKSZ(_DECKSZ), idx(_idx), cards_played(0) {
+    // Deal: Distribute one-one card each to player and dealer twice.
+    for (auto i = 0; i < 2; ++i) {
+      if (idx + cards_played < DECKSZ)
+        player.add(deck, idx + cards_played++);
+      else
+        break;
+      if (idx + cards_played < DECKSZ)
+        dealer.add(deck, idx + cards_played++);
+      else
+        break;
+    }
+  }
+
+  const hand_t &player_hand() const { return player; }
+
+  const hand_t &dealer_hand() const { return dealer; }
+
+  // The dealer's first card, seen by the player; deck[idx + 1].
+  const card_t *dealer_upcard() const {
+    return (dealer.ncards > 0) ? &deck[dealer.cards[0]] : nullptr;
+  }
+
+  // Player takes one more hit. Returns false, without any change, if the
+  // player has bust or the deck has run out: more hits change nothing.
+  bool hit() {
+    if (player.best() > 21 || idx + cards_played >= DECKSZ)
+      return false;
+    player.add(deck, idx + cards_played++);
+    return true;
+  }
+
+  // Plays the round with a hit policy: the player hits while
+  // policy(player_hand(), dealer_upcard()) says so, and then stands.
+  template <typename POLICY> round_res_t play(POLICY &&policy) {
+    while (policy(player, dealer_upcard()) && hit())
+      ;
+    return outcome();
+  }
+
+  // Outcome of the round if the player stands now.
+  round_res_t outcome() const {
+    const size_t player_value = player.best();
+    if (player_value > 21) // Player bust
+      return std::make_pair(cards_played, -1);
+
+    // Dealer's hits: Keep hitting till value < 17
+    size_t played = cards_played, low = dealer.low, aces = dealer.aces;
+    while (low + 10 * aces < 17) {
+      // If dealer has won, stop.
+      const size_t v = (low + 10 * aces > 21) ? low : low + 10 * aces;
+      if (v > player_value)
+        break;
+
+      if (idx + played < DECKSZ) {
+        low += card_points(deck[idx + played]);
+        aces += (deck[idx + played].first == 1);
+        ++played;
+      } else {
+        break;
+      }
+    }
+
+    const size_t dealer_value = (low + 10 * aces > 21) ? low : low + 10 * aces;
+    int player_income = 0;
+    if (dealer_value > 21) // Dealer bust
+      player_income = 1;
+    else if (player_value > dealer_value)
+      player_income = 1;
+    else if (player_value < dealer_value)
+      player_income = -1;
+    return std::make_pair(played, player_income);
+  }
+};
+
+// Same result as blackjack_dp_naive, including best_hit.
+// The outcomes for h hits are derived from those for h - 1. Once a hit
+// changes nothing (bust or empty deck) no larger h can do better, and a
+// player busts within 22 hits, so each round start takes O(1) outcomes:
+// O(n) in all, against O(n^2) for evaluating every (i, h).
+inline int blackjack_dp(const card_t *deck, size_t DECKSZ,
+                        std::vector<size_t> &best_hit) {
+  std::vector<int> max_profit(DECKSZ + 1);
+  best_hit.assign(DECKSZ + 1, 0);
+  max_profit[DECKSZ] = 0;
+
+  for (size_t i = DECKSZ; i-- > 0;) {
+    max_profit[i] = -1 * static_cast<int>(DECKSZ); // Min possible profit.
+    round_evaluator ev(deck, DECKSZ, i);
+    for (size_t h = 0; h < DECKSZ - i; ++h) {
+      if (h > 0 && !ev.hit())
+        break;
+      auto rout = ev.outcome();
+      if (rout.second + max_profit[i + rout.first] > max_profit[i]) {
+        max_profit[i] = rout.second + max_profit[i + rout.first];
+        best_hit[i] = h;
+      }
+    }
+  }
+
+  return max_profit[0];
+}
+
+// Shoe of ndecks decks in order.
+inline std::vector<card_t> make_ordered_shoe(size_t ndecks) {
+  std::vector<card_t> shoe;
+  for (size_t d = 0; d < ndecks; ++d)
+    for (int t = CLUB; t <= SPADE; ++t)
+      for (auto n = 1; n <= NCVALS; ++n)
+        shoe.push_back(std::make_pair(n, static_cast<card_type_t>(t)));
+  return shoe;
+}
+
+// Shoe of ndecks decks, shuffled with rand().
+inline std::vector<card_t> make_shoe(size_t ndecks) {
+  std::vector<card_t> shoe = make_ordered_shoe(ndecks);
+
+  // Shuffle.
+  for (size_t i = 0; i < shoe.size(); ++i)
+    std::swap(shoe[i], shoe[rand() % shoe.size()]);
+  return shoe;
+}
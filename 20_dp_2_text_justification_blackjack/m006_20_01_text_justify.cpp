@@ -6,44 +6,10 @@
 // in the file LICENSE in the source distribution.
 //
 
-#include <fstream>
 #include <iostream>
 #include <string>
-#include <vector>
 
-#define INFINITE 0x7FFFFFFFFFFFFFFF
-
-typedef std::vector<std::string> word_list_t;
-
-// Extracts words from a string and adds it to the word list.
-void extract_line_words(const std::string str, word_list_t &wl) {
-  std::string word;
-
-  for (std::string::size_type i = 0; i < str.length(); ++i) {
-    if (std::isalnum(str.at(i)) || std::ispunct(str.at(i))) {
-      word.push_back(static_cast<char>(str.at(i)));
-    } else if (!word.empty()) { // Non-alpha-numeric; end of current word.
-      wl.push_back(word);
-      word.clear();
-    }
-  }
-
-  // Last word
-  if (!word.empty()) {
-    wl.push_back(word);
-    word.clear();
-  }
-}
-
-// Reads a flie line-by-line, extracts words from each line and adds them
-// to the word list.
-void extract_file_words(const std::string &fname, word_list_t &wl) {
-  std::ifstream infile(fname);
-  std::string line;
-  while (std::getline(infile, line)) {
-    extract_line_words(line, wl);
-  }
-}
+#include "text_justify.hpp"
 
 // Returns the width of list of words starting at 'from' upto, but not
 // including, 'to' in the word list.
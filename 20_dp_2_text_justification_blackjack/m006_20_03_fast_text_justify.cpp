@@ -0,0 +1,140 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "text_justify.hpp"
+
+// The naive solver is cubic; skip it above this many words.
+#define NAIVE_MAX_WORDS 4000
+
+typedef std::function<size_t(const std::vector<size_t> &, size_t,
+                             std::vector<size_t> &)>
+    solver_t;
+
+// Runs solver, returning the time in ms.
+double time_solver(const solver_t &solver, const std::vector<size_t> &len,
+                   size_t width, std::vector<size_t> &next, size_t &bad) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  bad = solver(len, width, next);
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Badness of a given breaking, recomputed from the lines.
+size_t total_badness(const std::vector<size_t> &len, size_t width,
+                     const std::vector<size_t> &next) {
+  size_t total = 0;
+  for (size_t ls = 0; ls < len.size(); ls = next[ls]) {
+    size_t lw = next[ls] - ls - 1;
+    for (size_t i = ls; i < next[ls]; ++i)
+      lw += std::min(len[i], width);
+    total = saturating_add(total, line_badness(lw, width));
+  }
+  return total;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3 && argc != 4) {
+    std::cerr << "Usage: " << argv[0] << " <text_file_path> <width> [copies]"
+              << std::endl;
+    std::cerr << "  Justifies the text; with copies, benchmarks the solvers"
+              << std::endl
+              << "  on the text repeated 1, 10, ... up to copies times."
+              << std::endl;
+    return 1;
+  }
+
+  auto width = std::atoi(argv[2]);
+  if (width <= 0) {
+    std::cerr << "Invalid width: " << argv[2] << std::endl;
+    return 1;
+  }
+
+  word_list_t wl;
+  extract_file_words(argv[1], wl);
+  std::vector<size_t> len;
+  for (const auto &w : wl)
+    len.push_back(w.size());
+
+  if (argc == 3) {
+    std::vector<size_t> next;
+    justify_monotone_queue(len, width, next);
+    print_lines(std::cout, wl, next);
+    return 0;
+  }
+
+  const size_t copies = std::stoul(argv[3]);
+  const std::vector<std::pair<std::string, solver_t>> solvers = {
+      {"naive", justify_naive},
+      {"prefix-sum",
+       [](const std::vector<size_t> &l, size_t w, std::vector<size_t> &nls) {
+         return justify_prefix_sum(l, w, nls);
+       }},
+      {"monotone-queue",
+       [](const std::vector<size_t> &l, size_t w, std::vector<size_t> &nls) {
+         return justify_monotone_queue(l, w, nls);
+       }}};
+
+  bool ok = true;
+  std::cout << "Time (ms)" << std::endl;
+  std::cout << "     words  width";
+  for (const auto &s : solvers) {
+    std::cout.width(16);
+    std::cout << s.first;
+  }
+  std::cout << std::endl;
+
+  for (size_t c = 1; c <= copies; c *= 10) {
+    std::vector<size_t> book;
+    for (size_t k = 0; k < c; ++k)
+      book.insert(book.end(), len.begin(), len.end());
+
+    for (size_t w : {static_cast<size_t>(width), 4 * static_cast<size_t>(width),
+                     16 * static_cast<size_t>(width)}) {
+      std::cout.width(10);
+      std::cout << book.size();
+      std::cout.width(7);
+      std::cout << w;
+
+      std::vector<size_t> ref_next;
+      size_t ref_bad = INFINITE;
+      bool have_ref = false;
+      for (const auto &s : solvers) {
+        std::cout.width(16);
+        if (s.first == "naive" && book.size() > NAIVE_MAX_WORDS) {
+          std::cout << "-";
+          continue;
+        }
+        std::vector<size_t> next;
+        size_t bad;
+        std::cout << time_solver(s.second, book, w, next, bad);
+
+        // Every solver is optimal; the breaks of the first two agree.
+        ok = ok && total_badness(book, w, next) == bad;
+        if (!have_ref) {
+          ref_next = next;
+          ref_bad = bad;
+          have_ref = true;
+        } else {
+          ok = ok && bad == ref_bad;
+          if (s.first == "prefix-sum")
+            ok = ok && next == ref_next;
+        }
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  std::cout << (ok ? "Solutions match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "text_justify.hpp"
+
+// Input handed to a thread at a time, rounded up to a paragraph break.
+#define BATCH_BYTES (1 << 20)
+
+// Justifies the memory-mapped file paragraph by paragraph and writes it to
+// os. Each round cuts the next nthreads batches of whole paragraphs,
+// justifies them in parallel into per-thread buffers and writes the buffers
+// in order. Memory is bounded by nthreads batches of output plus the longest
+// paragraph; the mapped pages of each finished round are released.
+void stream_text_justify(mapped_file &mf, size_t width, size_t nthreads,
+                         std::ostream &os) {
+  const char *text = mf.data();
+  const size_t n = mf.size();
+  std::vector<paragraph_justifier> justifiers(nthreads,
+                                              paragraph_justifier(width));
+  std::vector<std::string> outs(nthreads);
+  bool first = true;
+
+  for (size_t pos = 0; pos < n;) {
+    std::vector<size_t> cuts = {pos};
+    while (cuts.size() <= nthreads && cuts.back() < n)
+      cuts.push_back(next_paragraph_break(
+          text, n, std::min(n, cuts.back() + BATCH_BYTES)));
+    const size_t nbatches = cuts.size() - 1;
+
+    auto work = [&](size_t t) {
+      outs[t].clear();
+      justifiers[t].justify(text + cuts[t], cuts[t + 1] - cuts[t], outs[t]);
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < nbatches; ++t)
+      workers.emplace_back(work, t);
+    work(0);
+    for (auto &w : workers)
+      w.join();
+
+    for (size_t t = 0; t < nbatches; ++t) {
+      // No separator before the first paragraph.
+      size_t skip = (first && !outs[t].empty()) ? 1 : 0;
+      first = first && outs[t].empty();
+      os.write(outs[t].data() + skip, outs[t].size() - skip);
+    }
+
+    mf.release(pos, cuts.back());
+    pos = cuts.back();
+  }
+  os.flush();
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3 && argc != 4) {
+    std::cerr << "Usage: " << argv[0] << " <text_file_path> <width> [threads]"
+              << std::endl;
+    return 1;
+  }
+
+  auto width = std::atoi(argv[2]);
+  if (width <= 0) {
+    std::cerr << "Invalid width: " << argv[2] << std::endl;
+    return 1;
+  }
+
+  size_t nthreads = std::max(1u, std::thread::hardware_concurrency());
+  if (argc == 4)
+    nthreads = std::max(1, std::atoi(argv[3]));
+
+  mapped_file mf(argv[1]);
+  if (!mf.valid()) {
+    std::cerr << "Cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::ios::sync_with_stdio(false);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  stream_text_justify(mf, width, nthreads, std::cout);
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  // Statistics go to stderr, away from the text.
+  double ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+  std::cerr << mf.size() << " bytes, " << nthreads << " threads, " << ms
+            << " ms, " << mf.size() / (1024.0 * 1024.0) / (ms / 1000.0)
+            << " MB/s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "blackjack.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// The naive DP is too slow above this many cards.
+#define NAIVE_MAX_CARDS 4200
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  bool ok = true;
+  std::cout << "Time (ms)" << std::endl;
+  std::cout << "   decks    cards   profit        naive  incremental"
+            << std::endl;
+  for (size_t copies : {1, 10, 100}) {
+    for (size_t decks : {1, 2, 4, 8}) {
+      auto shoe = make_shoe(decks * copies);
+
+      std::vector<size_t> best_hit;
+      auto t1 = std::chrono::high_resolution_clock::now();
+      int profit = blackjack_dp(shoe.data(), shoe.size(), best_hit);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      double fast_ms =
+          std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+      std::cout.width(8);
+      std::cout << decks * copies;
+      std::cout.width(9);
+      std::cout << shoe.size();
+      std::cout.width(9);
+      std::cout << profit;
+      std::cout.width(13);
+      if (shoe.size() <= NAIVE_MAX_CARDS) {
+        std::vector<size_t> naive_best_hit;
+        t1 = std::chrono::high_resolution_clock::now();
+        int naive_profit =
+            blackjack_dp_naive(shoe.data(), shoe.size(), naive_best_hit);
+        t2 = std::chrono::high_resolution_clock::now();
+        std::cout << std::chrono::duration<double, std::milli>(t2 - t1).count();
+        ok = ok && naive_profit == profit && naive_best_hit == best_hit;
+      } else {
+        std::cout << "-";
+      }
+      std::cout.width(13);
+      std::cout << fast_ms << std::endl;
+
+      // Play the deck as per the solution; it must earn the predicted profit.
+      int earned = 0;
+      for (size_t idx = 0; idx < shoe.size();) {
+        round_evaluator ev(shoe.data(), shoe.size(), idx);
+        for (size_t h = 0; h < best_hit[idx]; ++h)
+          ev.hit();
+        auto rout = ev.outcome();
+        idx += rout.first;
+        earned += rout.second;
+      }
+      ok = ok && earned == profit;
+    }
+  }
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
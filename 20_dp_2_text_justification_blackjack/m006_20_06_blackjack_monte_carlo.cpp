@@ -0,0 +1,210 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "blackjack.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // RNG seed
+
+#define SHOE_DECKS 8
+#define PENETRATION_PCT 75 // Rounds are dealt till this much of the shoe.
+#define SHOES_PER_BATCH 64 // Shoes a thread takes at a time.
+
+// Weyl sequence increment: 2 ^ 64 / phi.
+#define GOLDEN_GAMMA 0x9E3779B97F4A7C15ULL
+
+// Counter-based random numbers: the n-th number of stream s is a pure
+// function of (seed, s, n), the SplitMix64 finalizer of a Weyl sequence.
+// Shoe s always uses stream s, so the simulation gives the same result
+// whichever thread plays which shoe, for any number of threads.
+class counter_rng {
+private:
+  uint64_t key;
+  uint64_t counter;
+
+  static uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+public:
+  counter_rng(uint64_t seed, uint64_t stream)
+      : key(mix(seed ^ mix((stream + 1) * GOLDEN_GAMMA))), counter(0) {}
+
+  uint64_t next() { return mix(key + ++counter * GOLDEN_GAMMA); }
+
+  // Uniform in [0, n), by multiplication instead of modulo.
+  size_t below(size_t n) {
+    return static_cast<size_t>(
+        (static_cast<unsigned __int128>(next()) * n) >> 64);
+  }
+};
+
+// Player income over many hands: the mean and its 95% confidence interval.
+struct ev_stats_t {
+  uint64_t hands;
+  int64_t sum;
+  uint64_t sum_sq;
+
+  ev_stats_t() : hands(0), sum(0), sum_sq(0) {}
+
+  void add(int income) {
+    ++hands;
+    sum += income;
+    sum_sq += income * income;
+  }
+
+  void merge(const ev_stats_t &o) {
+    hands += o.hands;
+    sum += o.sum;
+    sum_sq += o.sum_sq;
+  }
+
+  double mean() const { return hands ? static_cast<double>(sum) / hands : 0; }
+
+  // Half width of the interval, normal approximation.
+  double ci95() const {
+    if (hands < 2)
+      return 0.0;
+    double m = mean();
+    double var = (static_cast<double>(sum_sq) - hands * m * m) / (hands - 1);
+    return 1.96 * std::sqrt(var / hands);
+  }
+
+  bool operator==(const ev_stats_t &o) const {
+    return hands == o.hands && sum == o.sum && sum_sq == o.sum_sq;
+  }
+};
+
+typedef std::function<bool(const hand_t &, const card_t *)> policy_t;
+
+// Plays nshoes shuffled shoes with the hit policy. Threads take batches of
+// shoes from a shared counter and keep their own shoe and statistics.
+ev_stats_t simulate(const policy_t &policy, size_t nshoes, size_t nthreads,
+                    uint64_t seed) {
+  const std::vector<card_t> ordered = make_ordered_shoe(SHOE_DECKS);
+  const size_t cut = ordered.size() * PENETRATION_PCT / 100;
+  std::atomic<size_t> next_batch(0);
+  std::vector<ev_stats_t> stats(nthreads);
+
+  auto work = [&](size_t t) {
+    std::vector<card_t> shoe;
+    ev_stats_t local;
+    for (size_t b; (b = SHOES_PER_BATCH * next_batch++) < nshoes;) {
+      for (size_t s = b; s < std::min(nshoes, b + SHOES_PER_BATCH); ++s) {
+        // Fisher-Yates shuffle.
+        counter_rng rng(seed, s);
+        shoe = ordered;
+        for (size_t i = shoe.size() - 1; i > 0; --i)
+          std::swap(shoe[i], shoe[rng.below(i + 1)]);
+
+        for (size_t idx = 0; idx < cut;) {
+          round_evaluator ev(shoe.data(), shoe.size(), idx);
+          auto rout = ev.play(policy);
+          idx += rout.first;
+          local.add(rout.second);
+        }
+      }
+    }
+    stats[t] = local;
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < nthreads; ++t)
+    workers.emplace_back(work, t);
+  work(0);
+  for (auto &w : workers)
+    w.join();
+
+  ev_stats_t total;
+  for (const auto &s : stats)
+    total.merge(s);
+  return total;
+}
+
+int main(int argc, char *argv[]) {
+  const size_t nshoes = (argc > 1) ? std::stoul(argv[1]) : 100000;
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+
+  // A strong dealer upcard is 7 or more, or an ace.
+  auto strong_upcard = [](const card_t *up) {
+    return up && (up->first == 1 || card_points(*up) >= 7);
+  };
+  const std::vector<std::pair<std::string, policy_t>> policies = {
+      {"never hit", [](const hand_t &, const card_t *) { return false; }},
+      {"hit below 12",
+       [](const hand_t &p, const card_t *) { return p.best() < 12; }},
+      {"hit below 17",
+       [](const hand_t &p, const card_t *) { return p.best() < 17; }},
+      {"upcard",
+       [strong_upcard](const hand_t &p, const card_t *up) {
+         return p.best() < (strong_upcard(up) ? 17u : 12u);
+       }}};
+
+  auto elapsed_ms = [](std::chrono::high_resolution_clock::time_point t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(t2 - t1).count();
+  };
+
+  std::cout << "Shoes: " << nshoes << " of " << SHOE_DECKS
+            << " decks, threads: " << hw << std::endl;
+  std::cout << "        policy        hands      EV/hand     +/- 95%"
+               "   Mhands/s"
+            << std::endl;
+  for (const auto &p : policies) {
+    auto t = std::chrono::high_resolution_clock::now();
+    auto stats = simulate(p.second, nshoes, hw, A_BIG_PRIME_NUMBER);
+    double ms = elapsed_ms(t);
+    std::cout.width(14);
+    std::cout << p.first;
+    std::cout.width(13);
+    std::cout << stats.hands;
+    std::cout.width(13);
+    std::cout << stats.mean();
+    std::cout.width(12);
+    std::cout << stats.ci95();
+    std::cout.width(11);
+    std::cout << stats.hands / (ms * 1000.0) << std::endl;
+  }
+
+  // Scaling; the statistics must not depend on the number of threads.
+  std::cout << std::endl
+            << "Policy: " << policies.back().first << std::endl
+            << "  threads   Mhands/s     per core" << std::endl;
+  bool ok = true;
+  ev_stats_t ref;
+  for (size_t nthreads = 1; nthreads <= std::max<size_t>(hw, 4);
+       nthreads *= 2) {
+    auto t = std::chrono::high_resolution_clock::now();
+    auto stats =
+        simulate(policies.back().second, nshoes, nthreads, A_BIG_PRIME_NUMBER);
+    double mhps = stats.hands / (elapsed_ms(t) * 1000.0);
+    if (nthreads == 1)
+      ref = stats;
+    ok = ok && stats == ref;
+    std::cout.width(9);
+    std::cout << nthreads;
+    std::cout.width(11);
+    std::cout << mhps;
+    std::cout.width(13);
+    std::cout << mhps / std::min(nthreads, hw) << std::endl;
+  }
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define INFINITE 0x7FFFFFFFFFFFFFFF
+
+typedef std::vector<std::string> word_list_t;
+
+// Extracts words from a string and adds it to the word list.
+inline void extract_line_words(const std::string str, word_list_t &wl) {
+  std::string word;
+
+  for (std::string::size_type i = 0; i < str.length(); ++i) {
+    if (std::isalnum(str.at(i)) || std::ispunct(str.at(i))) {
+      word.push_back(static_cast<char>(str.at(i)));
+    } else if (!word.empty()) { // Non-alpha-numeric; end of current word.
+      wl.push_back(word);
+      word.clear();
+    }
+  }
+
+  // Last word
+  if (!word.empty()) {
+    wl.push_back(word);
+    word.clear();
+  }
+}
+
+// Reads a flie line-by-line, extracts words from each line and adds them
+// to the word list.
+inline void extract_file_words(const std::string &fname, word_list_t &wl) {
+  std::ifstream infile(fname);
+  std::string line;
+  while (std::getline(infile, line)) {
+    extract_line_words(line, wl);
+  }
+}
+
+//
+// Line breaking solvers over word lengths.
+//
+// The input is the length of each word, len[0, n), and the line width. Each
+// solver fills next_line_start[0, n] (next_line_start[i] is where the line
+// starting at word i ends, exclusive) and returns the total badness: the sum
+// of the cubes of the unused widths of all lines, as in text_justify.
+// A word longer than the width is treated as exactly as long as the width,
+// so that it gets a line of its own. Badness sums saturate at INFINITE.
+//
+
+// a + b for a, b <= INFINITE; cannot wrap around.
+inline size_t saturating_add(size_t a, size_t b) {
+  return std::min<size_t>(a + b, INFINITE);
+}
+
+// Cubic badness of a line of the given width; INFINITE if it does not fit.
+inline size_t line_badness(size_t line_width, size_t width) {
+  if (line_width > width)
+    return INFINITE;
+  const size_t diff = width - line_width;
+  return std::min<size_t>(diff * diff * diff, INFINITE);
+}
+
+// Reference solver, O(n^3): the DP of text_justify, re-summing the word
+// lengths of every candidate line and never stopping early.
+inline size_t justify_naive(const std::vector<size_t> &len, size_t width,
+                            std::vector<size_t> &next_line_start) {
+  const size_t N = len.size();
+  std::vector<size_t> min_badness(N + 1);
+  next_line_start.assign(N + 1, N);
+  min_badness[N] = 0;
+
+  for (size_t i = N; i-- > 0;) {
+    min_badness[i] = INFINITE;
+    for (size_t j = i + 1; j <= N; ++j) {
+      size_t lw = j - i - 1; // Spaces between the words.
+      for (size_t k = i; k < j; ++k)
+        lw += std::min(len[k], width);
+      auto bad = saturating_add(line_badness(lw, width), min_badness[j]);
+      if (bad < min_badness[i]) {
+        min_badness[i] = bad;
+        next_line_start[i] = j;
+      }
+    }
+  }
+  return min_badness[0];
+}
+
+// Candidate next line start of justify_monotone_queue: j wins the line
+// starts [lo, lo of the candidate before it in the queue).
+struct justify_candidate_t {
+  size_t j;
+  size_t lo;
+};
+
+// Working memory of the solvers, reusable across calls.
+struct justify_scratch_t {
+  std::vector<size_t> prefix;
+  std::vector<size_t> min_badness;
+  std::deque<justify_candidate_t> queue;
+};
+
+// Prefix sums of the word widths, each counted with one trailing space:
+// the width of the line of words [i, j) is prefix[j] - prefix[i] - 1.
+inline void word_width_prefix(const std::vector<size_t> &len, size_t width,
+                              std::vector<size_t> &prefix) {
+  prefix.resize(len.size() + 1);
+  prefix[0] = 0;
+  for (size_t i = 0; i < len.size(); ++i)
+    prefix[i + 1] = prefix[i] + std::min(len[i], width) + 1;
+}
+
+// O(n * W): prefix-summed line widths, and the scan for the end of a line
+// stops as soon as the line overflows. A line holds at most (W + 1) / 2
+// words. Breaks ties like justify_naive, so the lines are identical.
+inline size_t justify_prefix_sum(const std::vector<size_t> &len, size_t width,
+                                 std::vector<size_t> &next_line_start,
+                                 justify_scratch_t &scratch) {
+  const size_t N = len.size();
+  std::vector<size_t> &prefix = scratch.prefix;
+  std::vector<size_t> &min_badness = scratch.min_badness;
+  word_width_prefix(len, width, prefix);
+  min_badness.resize(N + 1);
+  next_line_start.assign(N + 1, N);
+  min_badness[N] = 0;
+
+  for (size_t i = N; i-- > 0;) {
+    min_badness[i] = INFINITE;
+    for (size_t j = i + 1; j <= N; ++j) {
+      const size_t lw = prefix[j] - prefix[i] - 1;
+      if (lw > width)
+        break; // Longer lines do not fit either.
+      auto bad = saturating_add(line_badness(lw, width), min_badness[j]);
+      if (bad < min_badness[i]) {
+        min_badness[i] = bad;
+        next_line_start[i] = j;
+      }
+    }
+  }
+  return min_badness[0];
+}
+
+// O(n lg n), independent of the width.
+// The badness of a line [i, j) is a convex function of prefix[j] -
+// prefix[i] (infinite past the width is still convex), so it satisfies the
+// quadrangle inequality and the best next line start is monotone in i: a
+// later candidate j beats an earlier one on a suffix of the line starts.
+// Line starts are solved right to left keeping a queue of candidates, each
+// with the range of i it wins; a new candidate takes over a prefix of the
+// range, found by binary search. Any optimal breaking may be returned;
+// ties are not broken as in justify_naive.
+// Adapted from the O(n) SMAWK approach: the binary search is simpler and
+// has lower constants at the sizes of books.
+inline size_t justify_monotone_queue(const std::vector<size_t> &len,
+                                     size_t width,
+                                     std::vector<size_t> &next_line_start,
+                                     justify_scratch_t &scratch) {
+  const size_t N = len.size();
+  std::vector<size_t> &prefix = scratch.prefix;
+  std::vector<size_t> &min_badness = scratch.min_badness;
+  word_width_prefix(len, width, prefix);
+  min_badness.resize(N + 1);
+  next_line_start.assign(N + 1, N);
+  min_badness[N] = 0;
+
+  // Total badness of starting a line at i and the next one at j.
+  auto cost = [&](size_t i, size_t j) {
+    return saturating_add(line_badness(prefix[j] - prefix[i] - 1, width),
+                          min_badness[j]);
+  };
+
+  // Front: the largest j, winning the largest i.
+  std::deque<justify_candidate_t> &q = scratch.queue;
+  q.clear();
+
+  for (size_t i = N; i-- > 0;) {
+    // New candidate c = i + 1; the smaller j wins a prefix of the range.
+    const size_t c = i + 1;
+    while (!q.empty()) {
+      const justify_candidate_t &b = q.back();
+      const size_t b_hi = (q.size() > 1) ? q[q.size() - 2].lo - 1 : i;
+      if (cost(b_hi, c) <= cost(b_hi, b.j)) {
+        q.pop_back(); // c wins the whole range of b.
+        continue;
+      }
+      // b wins at b_hi; find the first i' in [b.lo, b_hi] b wins. b is
+      // the last candidate, so b.lo is 0.
+      size_t lo = b.lo, hi = b_hi;
+      while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cost(mid, c) <= cost(mid, b.j))
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      q.back().lo = lo; // c wins [0, lo).
+      break;
+    }
+    if (q.empty() || q.back().lo > 0)
+      q.push_back(justify_candidate_t{c, 0});
+
+    // Drop the candidates winning only line starts above i.
+    while (q.size() > 1 && q.front().lo > i)
+      q.pop_front();
+
+    min_badness[i] = cost(i, q.front().j);
+    next_line_start[i] = q.front().j;
+  }
+  return min_badness[0];
+}
+
+inline size_t justify_prefix_sum(const std::vector<size_t> &len, size_t width,
+                                 std::vector<size_t> &next_line_start) {
+  justify_scratch_t scratch;
+  return justify_prefix_sum(len, width, next_line_start, scratch);
+}
+
+inline size_t justify_monotone_queue(const std::vector<size_t> &len,
+                                     size_t width,
+                                     std::vector<size_t> &next_line_start) {
+  justify_scratch_t scratch;
+  return justify_monotone_queue(len, width, next_line_start, scratch);
+}
+
+// Writes the words, one line from next_line_start at a time.
+template <typename WORDS>
+void print_lines(std::ostream &os, const WORDS &wl,
+                 const std::vector<size_t> &next_line_start) {
+  const size_t N = wl.size();
+  for (size_t ls = 0; ls < N; ls = next_line_start[ls]) {
+    const char *delim = "";
+    for (size_t i = ls; i < next_line_start[ls]; ++i) {
+      os << delim << wl[i];
+      delim = " ";
+    }
+    os << std::endl;
+  }
+}
+
+// Justifies text a paragraph at a time.
+// Paragraphs are separated by lines without words. Words are the maximal
+// runs of printable non-blank characters, as extract_line_words takes them,
+// and are kept as views into the text; the word and DP buffers are reused
+// from paragraph to paragraph, so memory is bounded by the longest
+// paragraph.
+class paragraph_justifier {
+private:
+  const size_t width;
+  std::vector<std::string_view> words;
+  std::vector<size_t> len;
+  std::vector<size_t> next_line_start;
+  justify_scratch_t scratch;
+
+  // std::isalnum(c) || std::ispunct(c) in the "C" locale.
+  static bool is_word_char(char c) { return c > ' ' && c < 127; }
+
+  void flush_paragraph(std::string &out) {
+    if (words.empty())
+      return;
+    // The prefix sum scan is faster for narrow lines, the monotone queue
+    // for wide ones.
+    if (width <= 128)
+      justify_prefix_sum(len, width, next_line_start, scratch);
+    else
+      justify_monotone_queue(len, width, next_line_start, scratch);
+
+    out.push_back('\n'); // Paragraph separator.
+    for (size_t ls = 0; ls < words.size(); ls = next_line_start[ls]) {
+      for (size_t i = ls; i < next_line_start[ls]; ++i) {
+        if (i > ls)
+          out.push_back(' ');
+        out.append(words[i].data(), words[i].size());
+      }
+      out.push_back('\n');
+    }
+    words.clear();
+    len.clear();
+  }
+
+public:
+  explicit paragraph_justifier(size_t _width) : width(_width) {}
+
+  // Appends the justified paragraphs of text[0, n) to out, each preceded by
+  // an empty line. text must not end inside a paragraph.
+  void justify(const char *text, size_t n, std::string &out) {
+    bool line_has_words = false;
+    for (size_t i = 0; i < n;) {
+      if (is_word_char(text[i])) {
+        size_t j = i + 1;
+        while (j < n && is_word_char(text[j]))
+          ++j;
+        words.emplace_back(text + i, j - i);
+        len.push_back(j - i);
+        line_has_words = true;
+        i = j;
+      } else {
+        if (text[i] == '\n') {
+          if (!line_has_words)
+            flush_paragraph(out);
+          line_has_words = false;
+        }
+        ++i;
+      }
+    }
+    flush_paragraph(out);
+  }
+};
+
+// End of the first blank (wordless) line at or after from, or n: a place
+// where text[0, n) can be cut between paragraphs.
+inline size_t next_paragraph_break(const char *text, size_t n, size_t from) {
+  bool line_has_words = true;
+  for (size_t i = from; i < n; ++i) {
+    if (text[i] == '\n') {
+      if (!line_has_words)
+        return i + 1;
+      line_has_words = false;
+    } else if (text[i] > ' ' && text[i] < 127) {
+      line_has_words = true;
+    }
+  }
+  return n;
+}
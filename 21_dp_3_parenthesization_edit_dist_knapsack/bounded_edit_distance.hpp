@@ -0,0 +1,228 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "edit_distance.hpp"
+
+// Threshold-bounded edit distance: each function returns the distance when
+// it is at most k and k + 1 otherwise, in O(k n) time instead of O(M N).
+
+namespace bounded_edit_util {
+// Cost of reaching a cell outside the band; leaves room to add costs.
+const size_t UNREACHABLE = SIZE_MAX / 4;
+
+// The suffix DP of edit_distance_dp over the cells (i, j) with |j - i| <= k.
+// Any path leaving the band makes more than k insertions or deletions, so
+// the band holds every path of cost <= k as long as those cost at least 1,
+// as they do with edit_cost and edit_cost_noreplace.
+// Stops at the first row costing more than k throughout.
+// Two rows of 2 k + 1 costs; with table, the operations of every banded
+// cell, table[i * (2 k + 1) + j - i + k], for the trace back.
+inline size_t banded(const std::string &x, const std::string &y,
+                     cost_func_t costfunc, size_t k,
+                     std::vector<uint8_t> *table) {
+  const ssize_t M = x.length(), N = y.length(), K = k, B = 2 * K + 1;
+  if (std::abs(M - N) > K)
+    return k + 1;
+
+  std::vector<size_t> below(B, UNREACHABLE), row(B, UNREACHABLE);
+  if (table)
+    table->assign((M + 1) * B, NOOP);
+
+  // Operations, with the shift of i and of the band offset j - i + k.
+  const transform_op_t ops[] = {NOOP, INSERT, DELETE, REPLACE};
+  const ssize_t xopshift[] = {1, 0, 1, 1};
+  const ssize_t bopshift[] = {0, 1, -1, 0};
+
+  for (ssize_t i = M; i >= 0; --i) {
+    std::fill(row.begin(), row.end(), UNREACHABLE);
+    const ssize_t j_lo = std::max<ssize_t>(0, i - K);
+    const ssize_t j_hi = std::min(N, i + K);
+    for (ssize_t j = j_hi; j >= j_lo; --j) {
+      const ssize_t b = j - i + K;
+      if (i == M && j == N) {
+        row[b] = 0;
+        continue;
+      }
+      for (size_t o = 0; o < 4; ++o) {
+        const ssize_t nb = b + bopshift[o];
+        if (i + xopshift[o] > M || j + (o != 2) > N || nb < 0 || nb >= B)
+          continue;
+        const size_t next = xopshift[o] ? below[nb] : row[nb];
+        if (next >= UNREACHABLE)
+          continue;
+        const size_t cost = costfunc(i < M ? x[i] : '\0',
+                                     j < N ? y[j] : '\0', ops[o]) +
+                            next;
+        if (cost < row[b]) {
+          row[b] = cost;
+          if (table)
+            (*table)[i * B + b] = ops[o];
+        }
+      }
+    }
+    // Every path crosses every row.
+    if (*std::min_element(row.begin(), row.end()) > k)
+      return k + 1;
+    std::swap(row, below);
+  }
+
+  return std::min(below[K], k + 1);
+}
+
+// Row where the slide of e edits on diagonal d starts, from the rows P of
+// e - 1 edits, or -1. op is the edit taking it there from diagonal from, or
+// NOOP where e - 1 edits reach as far.
+inline ssize_t lv_start(const std::vector<ssize_t> &P, ssize_t d, ssize_t M,
+                        ssize_t N, transform_op_t &op, ssize_t &from) {
+  // P has the diagonals -(e - 1) ... e - 1.
+  const size_t mid = P.size() / 2;
+  auto prev = [&](ssize_t pd) {
+    const size_t at = mid + pd;
+    return at < P.size() ? P[at] : -1;
+  };
+  ssize_t start = -1;
+  auto consider = [&](ssize_t row, ssize_t pd, transform_op_t o) {
+    if (row > start) {
+      start = row;
+      from = pd;
+      op = o;
+    }
+  };
+  // Rows i on diagonal d have i + d <= N.
+  const ssize_t last = N - d;
+  const ssize_t s = prev(d), l = prev(d - 1), r = prev(d + 1);
+  if (s >= 0)
+    consider(s, d, NOOP);
+  if (s >= 0 && s < M && s < last)
+    consider(s + 1, d, REPLACE);
+  if (l >= 0 && l <= last)
+    consider(l, d - 1, INSERT);
+  if (r >= 0 && r < M)
+    consider(r + 1, d + 1, DELETE);
+  return start;
+}
+
+// Landau-Vishkin with unit costs: furthest[e][d + e] is the furthest row i
+// on diagonal d = j - i reached with e edits, after sliding over matches.
+inline size_t landau_vishkin(const std::string &x, const std::string &y,
+                             size_t k,
+                             std::vector<std::vector<ssize_t>> &furthest) {
+  const ssize_t M = x.length(), N = y.length(), K = k;
+  furthest.clear();
+  if (std::abs(M - N) > K)
+    return k + 1;
+
+  for (ssize_t e = 0; e <= K; ++e) {
+    furthest.emplace_back(2 * e + 1, -1);
+    auto &L = furthest.back();
+    for (ssize_t d = std::max(-e, -M); d <= std::min(e, N); ++d) {
+      transform_op_t op;
+      ssize_t from;
+      ssize_t i = e ? lv_start(furthest[e - 1], d, M, N, op, from) : 0;
+      if (i < 0)
+        continue;
+      while (i < M && i + d < N && x[i] == y[i + d])
+        ++i;
+      L[d + e] = i;
+    }
+    if (std::abs(N - M) <= e && L[N - M + e] >= M)
+      return e;
+  }
+  return k + 1;
+}
+
+// Operations of the path found by landau_vishkin, walking back from the end
+// of the last diagonal.
+inline void landau_vishkin_ops(const std::string &x, const std::string &y,
+                               const std::vector<std::vector<ssize_t>> &L,
+                               std::vector<transform_op_t> &ops) {
+  const ssize_t M = x.length(), N = y.length();
+  ops.clear();
+  ssize_t d = N - M, i = M;
+  for (ssize_t e = L.size() - 1; e >= 0; --e) {
+    transform_op_t op = NOOP;
+    ssize_t from = d;
+    const ssize_t start = e ? lv_start(L[e - 1], d, M, N, op, from) : 0;
+    // Matches slid over.
+    for (; i > start; --i)
+      ops.push_back(NOOP);
+    if (op != NOOP)
+      ops.push_back(op);
+    if (op == REPLACE || op == DELETE)
+      --i;
+    d = from;
+  }
+  std::reverse(ops.begin(), ops.end());
+}
+} // namespace bounded_edit_util
+
+// Banded DP for any costfunc whose insertions and deletions cost at least 1,
+// in O(k) space.
+inline size_t edit_distance_banded(const std::string &x, const std::string &y,
+                                   cost_func_t costfunc, size_t k) {
+  return bounded_edit_util::banded(x, y, costfunc, k, nullptr);
+}
+
+// Banded DP with the trace back of edit_distance_dp, in O(k M) space; ops is
+// left empty beyond k.
+inline size_t edit_distance_banded(const std::string &x, const std::string &y,
+                                   cost_func_t costfunc, size_t k,
+                                   std::vector<transform_op_t> &ops) {
+  std::vector<uint8_t> table;
+  const size_t d = bounded_edit_util::banded(x, y, costfunc, k, &table);
+  ops.clear();
+  if (d > k)
+    return d;
+
+  const size_t B = 2 * k + 1;
+  size_t i = 0, j = 0;
+  while (i < x.length() || j < y.length()) {
+    auto op = static_cast<transform_op_t>(table[i * B + j + k - i]);
+    ops.push_back(op);
+    i += op != INSERT;
+    j += op != DELETE;
+  }
+  return d;
+}
+
+// Ukkonen's diagonal extension (Landau-Vishkin) for the unit costs of
+// edit_cost: O(k n) time at worst and O(n + k^2) on similar strings, O(k^2)
+// space, stopping as soon as k edits are exceeded.
+inline size_t edit_distance_ukkonen(const std::string &x, const std::string &y,
+                                    size_t k) {
+  std::vector<std::vector<ssize_t>> furthest;
+  return bounded_edit_util::landau_vishkin(x, y, k, furthest);
+}
+
+// The same with an optimal alignment, not necessarily edit_distance_dp's on
+// ties; ops is left empty beyond k.
+inline size_t edit_distance_ukkonen(const std::string &x, const std::string &y,
+                                    size_t k,
+                                    std::vector<transform_op_t> &ops) {
+  std::vector<std::vector<ssize_t>> furthest;
+  const size_t d = bounded_edit_util::landau_vishkin(x, y, k, furthest);
+  ops.clear();
+  if (d <= k)
+    bounded_edit_util::landau_vishkin_ops(x, y, furthest, ops);
+  return d;
+}
+
+// Whether the distance is within k: Ukkonen for edit_cost, the band
+// otherwise.
+inline bool edit_distance_within(const std::string &x, const std::string &y,
+                                 cost_func_t costfunc, size_t k) {
+  if (&costfunc == &edit_cost)
+    return edit_distance_ukkonen(x, y, k) <= k;
+  return edit_distance_banded(x, y, costfunc, k) <= k;
+}
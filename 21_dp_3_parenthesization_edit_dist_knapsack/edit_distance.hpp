@@ -0,0 +1,415 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "wavefront.hpp"
+
+#define INFINITE 0x1FFFFFFF
+
+// Largest sub-problem solved with a full table by Hirschberg's recursion.
+#define EDIT_BASE_AREA (1 << 14)
+
+// Side of the tiles of edit_distance_wavefront.
+#define EDIT_TILE 256
+
+// Types of operations.
+enum transform_op_t { NOOP, INSERT, DELETE, REPLACE };
+
+inline std::ostream &operator<<(std::ostream &os, const transform_op_t &op) {
+  switch (op) {
+  case INSERT:
+    os << 'I';
+    break;
+  case DELETE:
+    os << 'D';
+    break;
+  case NOOP:
+    os << '.';
+    break;
+  case REPLACE:
+    os << 'R';
+    break;
+  default:
+    os << 'X';
+    break;
+  }
+
+  return os;
+}
+
+typedef size_t (&cost_func_t)(char, char, transform_op_t);
+
+inline size_t edit_cost(char c1, char c2, transform_op_t op) {
+  switch (op) {
+  case INSERT:
+  case DELETE:
+    return 1;
+  case NOOP:
+    return (c1 == c2) ? 0 : INFINITE;
+  case REPLACE:
+    return (c1 == c2) ? INFINITE : 1;
+  default:
+    break;
+  }
+
+  return INFINITE;
+}
+
+inline size_t edit_cost_noreplace(char c1, char c2, transform_op_t op) {
+  switch (op) {
+  case INSERT:
+  case DELETE:
+    return 1;
+  case NOOP:
+    return (c1 == c2) ? 0 : INFINITE;
+  case REPLACE:
+    return INFINITE;
+  default:
+    break;
+  }
+
+  return INFINITE;
+}
+
+// Prints the operations transforming x into y, in the format of
+// edit_distance_dp.
+inline void print_edit_ops(const std::string &x, const std::string &y,
+                           const std::vector<transform_op_t> &ops) {
+  size_t i = 0, j = 0;
+  for (auto op : ops) {
+    std::cout << "[" << i << "," << j << "] : ";
+    switch (op) {
+    case NOOP:
+      std::cout << "NOOP " << x[i] << std::endl;
+      ++i;
+      ++j;
+      break;
+
+    case REPLACE:
+      std::cout << "REPLACE " << x[i] << " -> " << y[j] << std::endl;
+      ++i;
+      ++j;
+      break;
+
+    case INSERT:
+      std::cout << "INSERT " << y[j] << std::endl;
+      ++j;
+      break;
+
+    case DELETE:
+      std::cout << "DELETE " << x[i] << std::endl;
+      ++i;
+      break;
+
+    default:
+      std::cout << "INVALID " << std::endl;
+      return;
+    }
+  }
+}
+
+// Sum of the costs of the operations transforming x into y.
+inline size_t edit_ops_cost(const std::string &x, const std::string &y,
+                            const std::vector<transform_op_t> &ops,
+                            cost_func_t costfunc) {
+  size_t i = 0, j = 0, cost = 0;
+  for (auto op : ops) {
+    cost += costfunc(i < x.length() ? x[i] : '\0',
+                     j < y.length() ? y[j] : '\0', op);
+    i += op != INSERT;
+    j += op != DELETE;
+  }
+  return cost;
+}
+
+namespace edit_distance_util {
+// The grid of the DP on x and y: cell (i, j) is the pair of suffixes x[i ...]
+// and y[j ...], and op at (i, j) costs costfunc(x[i], y[j], op) with '\0'
+// past the ends, as in edit_distance_dp.
+// A transposed grid walks y by i and x by j; INSERT and DELETE swap, the
+// path and its costs do not.
+struct edit_grid_t {
+  const std::string &x;
+  const std::string &y;
+  cost_func_t costfunc;
+  bool transposed;
+
+  size_t cost(size_t i, size_t j, transform_op_t op) const {
+    const char a = i < x.length() ? x[i] : '\0';
+    const char b = j < y.length() ? y[j] : '\0';
+    if (!transposed)
+      return costfunc(a, b, op);
+    return costfunc(b, a, swapped(op));
+  }
+
+  static transform_op_t swapped(transform_op_t op) {
+    return op == INSERT ? DELETE : op == DELETE ? INSERT : op;
+  }
+
+  edit_grid_t transpose() const { return {y, x, costfunc, !transposed}; }
+};
+
+// Rows of the DP reused by every level of the recursion.
+struct edit_scratch_t {
+  std::vector<size_t> forward;
+  std::vector<size_t> backward;
+  std::vector<size_t> table;
+  std::vector<uint8_t> table_op;
+};
+
+// forward[j - j0] = least cost from (i0, j0) to (i1, j), for j0 <= j <= j1,
+// one row at a time.
+inline void forward_row(const edit_grid_t &g, size_t i0, size_t i1,
+                        size_t j0, size_t j1, std::vector<size_t> &row) {
+  const size_t W = j1 - j0;
+  row.resize(W + 1);
+  row[0] = 0;
+  for (size_t j = 1; j <= W; ++j)
+    row[j] = row[j - 1] + g.cost(i0, j0 + j - 1, INSERT);
+  for (size_t i = i0 + 1; i <= i1; ++i) {
+    size_t diag = row[0];
+    row[0] += g.cost(i - 1, j0, DELETE);
+    for (size_t j = 1; j <= W; ++j) {
+      const size_t c = j0 + j - 1;
+      size_t best = diag + std::min(g.cost(i - 1, c, NOOP),
+                                    g.cost(i - 1, c, REPLACE));
+      best = std::min(best, row[j - 1] + g.cost(i, c, INSERT));
+      best = std::min(best, row[j] + g.cost(i - 1, c + 1, DELETE));
+      diag = row[j];
+      row[j] = best;
+    }
+  }
+}
+
+// backward[j - j0] = least cost from (i0, j) to (i1, j1), for j0 <= j <= j1.
+inline void backward_row(const edit_grid_t &g, size_t i0, size_t i1,
+                         size_t j0, size_t j1, std::vector<size_t> &row) {
+  const size_t W = j1 - j0;
+  row.resize(W + 1);
+  row[W] = 0;
+  for (size_t j = W; j-- > 0;)
+    row[j] = row[j + 1] + g.cost(i1, j0 + j, INSERT);
+  for (size_t i = i1; i-- > i0;) {
+    size_t diag = row[W];
+    row[W] += g.cost(i, j1, DELETE);
+    for (size_t j = W; j-- > 0;) {
+      const size_t c = j0 + j;
+      size_t best =
+          diag + std::min(g.cost(i, c, NOOP), g.cost(i, c, REPLACE));
+      best = std::min(best, row[j + 1] + g.cost(i, c, INSERT));
+      best = std::min(best, row[j] + g.cost(i, c, DELETE));
+      diag = row[j];
+      row[j] = best;
+    }
+  }
+}
+
+// Least cost operations from (i0, j0) to (i1, j1) with a full table, taking
+// the first of NOOP, INSERT, DELETE, REPLACE on ties as edit_distance_dp does.
+inline void align_table(const edit_grid_t &g, size_t i0, size_t i1,
+                        size_t j0, size_t j1, edit_scratch_t &s,
+                        std::vector<transform_op_t> &ops) {
+  const size_t H = i1 - i0, W = j1 - j0;
+  s.table.assign((H + 1) * (W + 1), 0);
+  s.table_op.assign((H + 1) * (W + 1), NOOP);
+  auto at = [W](size_t i, size_t j) { return i * (W + 1) + j; };
+
+  // Topological Order: each cell depends on the cell at right, down or
+  // diagonal.
+  for (size_t i = H + 1; i-- > 0;) {
+    for (size_t j = W + 1; j-- > 0;) {
+      if (i == H && j == W)
+        continue;
+      size_t best = SIZE_MAX;
+      auto relax = [&](transform_op_t op, size_t ni, size_t nj) {
+        if (ni > H || nj > W)
+          return;
+        size_t cost = g.cost(i0 + i, j0 + j, op) + s.table[at(ni, nj)];
+        if (cost < best) {
+          best = cost;
+          s.table_op[at(i, j)] = op;
+        }
+      };
+      relax(NOOP, i + 1, j + 1);
+      if (!g.transposed) {
+        relax(INSERT, i, j + 1);
+        relax(DELETE, i + 1, j);
+      } else {
+        relax(DELETE, i + 1, j);
+        relax(INSERT, i, j + 1);
+      }
+      relax(REPLACE, i + 1, j + 1);
+      s.table[at(i, j)] = best;
+    }
+  }
+
+  size_t i = 0, j = 0;
+  while (i < H || j < W) {
+    auto op = static_cast<transform_op_t>(s.table_op[at(i, j)]);
+    ops.push_back(g.transposed ? edit_grid_t::swapped(op) : op);
+    i += op != INSERT;
+    j += op != DELETE;
+  }
+}
+
+// Hirschberg's divide and conquer: every path from (i0, j0) to (i1, j1)
+// crosses the middle row, at the column minimizing forward + backward cost.
+// The longer side is always the one halved, so the rows span the shorter.
+inline void align_hirschberg(const edit_grid_t &g, size_t i0, size_t i1,
+                             size_t j0, size_t j1, edit_scratch_t &s,
+                             std::vector<transform_op_t> &ops) {
+  if ((i1 - i0 + 1) * (j1 - j0 + 1) <= EDIT_BASE_AREA)
+    return align_table(g, i0, i1, j0, j1, s, ops);
+  if (j1 - j0 > i1 - i0)
+    return align_hirschberg(g.transpose(), j0, j1, i0, i1, s, ops);
+
+  const size_t mid = i0 + (i1 - i0) / 2;
+  forward_row(g, i0, mid, j0, j1, s.forward);
+  backward_row(g, mid, i1, j0, j1, s.backward);
+  size_t split = 0;
+  for (size_t j = 1; j <= j1 - j0; ++j)
+    if (s.forward[j] + s.backward[j] <
+        s.forward[split] + s.backward[split])
+      split = j;
+
+  align_hirschberg(g, i0, mid, j0, j0 + split, s, ops);
+  align_hirschberg(g, mid, i1, j0 + split, j1, s, ops);
+}
+} // namespace edit_distance_util
+
+// Least cost to transform x into y, with two rows of min(M, N) + 1 costs.
+inline size_t edit_distance_linear(const std::string &x, const std::string &y,
+                                   cost_func_t costfunc) {
+  using namespace edit_distance_util;
+  const edit_grid_t xy = {x, y, costfunc, false};
+  const edit_grid_t g = y.length() > x.length() ? xy.transpose() : xy;
+  std::vector<size_t> row;
+  backward_row(g, 0, g.x.length(), 0, g.y.length(), row);
+  return row[0];
+}
+
+// Least cost operations to transform x into y, in O(min(M, N)) space beside
+// the M + N operations, and O(M N) time.
+inline size_t edit_distance_hirschberg(const std::string &x,
+                                       const std::string &y,
+                                       cost_func_t costfunc,
+                                       std::vector<transform_op_t> &ops) {
+  using namespace edit_distance_util;
+  ops.clear();
+  edit_scratch_t s;
+  align_hirschberg({x, y, costfunc, false}, 0, x.length(), 0, y.length(), s,
+                   ops);
+  return edit_ops_cost(x, y, ops, costfunc);
+}
+
+// One row of a tile of the unit cost DP in prefix form,
+// D[i][j] = min(D[i - 1][j - 1] + (x[i - 1] != y[j - 1]), D[i - 1][j] + 1,
+//               D[i][j - 1] + 1),
+// from the row above, prev[0 ... W], and cur[0] = D[i][j0 - 1]; yc holds
+// y[j0 - 1 ...].
+typedef void (*edit_row_kernel_t)(const uint32_t *prev, uint32_t *cur,
+                                  char xc, const char *yc, size_t W);
+
+namespace edit_distance_util {
+// The diagonal and upper neighbours have no dependency within the row and
+// go first; the left neighbour is a running minimum after.
+inline void edit_row_scan(uint32_t *cur, size_t W) {
+  for (size_t j = 1; j <= W; ++j)
+    cur[j] = std::min(cur[j], cur[j - 1] + 1);
+}
+
+inline void edit_row_scalar(const uint32_t *prev, uint32_t *cur, char xc,
+                            const char *yc, size_t W) {
+  for (size_t j = 1; j <= W; ++j)
+    cur[j] = std::min(prev[j - 1] + (xc != yc[j - 1]), prev[j] + 1);
+  edit_row_scan(cur, W);
+}
+
+__attribute__((target("avx2"))) inline void
+edit_row_avx2(const uint32_t *prev, uint32_t *cur, char xc, const char *yc,
+              size_t W) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i x8 = _mm256_set1_epi32(static_cast<unsigned char>(xc));
+  size_t j = 1;
+  for (; j + 8 <= W + 1; j += 8) {
+    const __m256i y8 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+        reinterpret_cast<const __m128i *>(yc + j - 1)));
+    const __m256i mismatch =
+        _mm256_andnot_si256(_mm256_cmpeq_epi32(x8, y8), one);
+    const __m256i diag = _mm256_add_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev + j - 1)),
+        mismatch);
+    const __m256i up = _mm256_add_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev + j)), one);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(cur + j),
+                        _mm256_min_epu32(diag, up));
+  }
+  for (; j <= W; ++j)
+    cur[j] = std::min(prev[j - 1] + (xc != yc[j - 1]), prev[j] + 1);
+  edit_row_scan(cur, W);
+}
+} // namespace edit_distance_util
+
+// The fastest row kernel the CPU supports.
+inline edit_row_kernel_t select_edit_row_kernel() {
+  if (__builtin_cpu_supports("avx2"))
+    return edit_distance_util::edit_row_avx2;
+  return edit_distance_util::edit_row_scalar;
+}
+
+// Levenshtein distance (the costs of edit_cost) with the table cut in
+// EDIT_TILE x EDIT_TILE tiles run by wavefront on nthreads threads.
+// Only the borders between tiles are kept: the bottom row of the tiles
+// above in top, the right column of the tiles to the left in left, and
+// for each row of tiles the corner above and to the left of its next tile.
+inline size_t edit_distance_wavefront(const std::string &x,
+                                      const std::string &y, size_t nthreads,
+                                      edit_row_kernel_t kernel =
+                                          select_edit_row_kernel()) {
+  const size_t M = x.length(), N = y.length(), T = EDIT_TILE;
+  if (!M || !N)
+    return M + N;
+
+  // D[0][j] = j and D[i][0] = i.
+  std::vector<uint32_t> top(N + 1), left(M + 1), corner((M + T - 1) / T);
+  for (size_t j = 0; j <= N; ++j)
+    top[j] = j;
+  for (size_t i = 0; i <= M; ++i)
+    left[i] = i;
+  for (size_t ti = 0; ti < corner.size(); ++ti)
+    corner[ti] = ti * T;
+
+  wavefront(corner.size(), (N + T - 1) / T, nthreads,
+            [&](size_t ti, size_t tj) {
+              // Rows r0 ... r1 and columns c0 ... c1 of D, from 1.
+              const size_t r0 = ti * T + 1, r1 = std::min(M, r0 + T - 1);
+              const size_t c0 = tj * T + 1, c1 = std::min(N, c0 + T - 1);
+              const size_t W = c1 - c0 + 1;
+              uint32_t rows[2][EDIT_TILE + 1];
+              uint32_t *prev = rows[0], *cur = rows[1];
+              prev[0] = corner[ti];
+              std::copy(&top[c0], &top[c1] + 1, prev + 1);
+              corner[ti] = top[c1];
+              for (size_t r = r0; r <= r1; ++r) {
+                cur[0] = left[r];
+                kernel(prev, cur, x[r - 1], &y[c0 - 1], W);
+                left[r] = cur[W];
+                std::swap(prev, cur);
+              }
+              std::copy(prev + 1, prev + W + 1, &top[c0]);
+            });
+  return top[N];
+}
@@ -0,0 +1,233 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Groups of first-level subtrees of the trie handed to threads.
+#define FUZZY_SHARDS 64
+
+// A dictionary word within the distance bound of a query.
+struct fuzzy_match_t {
+  uint32_t word;
+  uint32_t distance;
+
+  bool operator<(const fuzzy_match_t &o) const { return word < o.word; }
+  bool operator==(const fuzzy_match_t &o) const {
+    return word == o.word && distance == o.distance;
+  }
+};
+
+// Levenshtein search of queries in a fixed dictionary, returning distances
+// only.
+// The words are kept in a trie laid out in preorder, so the subtree of node
+// v is the range [v, end) and a depth-first walk is a scan that jumps to
+// end to skip a subtree. Walking the trie extends every word sharing a
+// prefix by one character at a time, so the work on the prefix is shared.
+// The state per trie depth is the bit-parallel automaton of Wu and Manber:
+// R[e] bit i is set iff the query prefix of i characters is within e edits
+// of the trie prefix. Once R[k] is empty no word below is within k, and the
+// subtree is skipped. A word's distance is the least e with bit m in R[e].
+// The first-level subtrees are grouped in FUZZY_SHARDS shards of about the
+// same size, searched by threads in parallel.
+class fuzzy_dictionary {
+private:
+  struct node_t {
+    uint32_t end;         // One past the subtree.
+    uint32_t words_begin; // Words ending here: sorted[words_begin ...
+    uint32_t words_end;   // ... words_end).
+    uint16_t depth;
+    char c;
+  };
+
+  std::vector<node_t> nodes; // nodes[0] is the root, the empty prefix.
+  std::vector<uint32_t> sorted; // Word ids in the order of their strings.
+  std::vector<uint32_t> shards; // Shard s is nodes shards[s] ... s + 1.
+  size_t max_depth = 0;
+
+  void search_shard(const std::string &query, size_t k, size_t shard,
+                    std::vector<uint64_t> &state,
+                    std::vector<fuzzy_match_t> &matches) const;
+
+public:
+  explicit fuzzy_dictionary(const std::vector<std::string> &words);
+
+  size_t trie_nodes() const { return nodes.size(); }
+
+  // Words within k edits of query, by word id, on nthreads threads.
+  void search(const std::string &query, size_t k,
+              std::vector<fuzzy_match_t> &matches, size_t nthreads) const;
+
+  // search for each query; the threads take (query, shard) pairs.
+  void search_batch(const std::vector<std::string> &queries, size_t k,
+                    std::vector<std::vector<fuzzy_match_t>> &matches,
+                    size_t nthreads) const;
+};
+
+inline fuzzy_dictionary::fuzzy_dictionary(
+    const std::vector<std::string> &words)
+    : sorted(words.size()) {
+  std::iota(sorted.begin(), sorted.end(), 0);
+  std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) {
+    return words[a] < words[b];
+  });
+
+  // Nodes of the current word's path; a word shares the prefix of the
+  // previous one, and the nodes past it are closed.
+  nodes.push_back({0, 0, 0, 0, '\0'});
+  std::vector<uint32_t> path = {0};
+  const std::string *prev = nullptr;
+  for (uint32_t s = 0; s < sorted.size(); ++s) {
+    const std::string &w = words[sorted[s]];
+    size_t lcp = 0;
+    if (prev)
+      while (lcp < prev->length() && lcp < w.length() &&
+             (*prev)[lcp] == w[lcp])
+        ++lcp;
+    while (path.size() > lcp + 1) {
+      nodes[path.back()].end = nodes.size();
+      path.pop_back();
+    }
+    for (size_t d = lcp; d < w.length(); ++d) {
+      path.push_back(nodes.size());
+      nodes.push_back({0, s, s, static_cast<uint16_t>(d + 1), w[d]});
+    }
+    max_depth = std::max(max_depth, w.length());
+    node_t &last = nodes[path.back()];
+    if (last.words_begin == last.words_end)
+      last.words_begin = s;
+    last.words_end = s + 1;
+    prev = &w;
+  }
+  for (auto v : path)
+    nodes[v].end = nodes.size();
+
+  // Shards of whole first-level subtrees.
+  const size_t target = nodes.size() / FUZZY_SHARDS + 1;
+  shards.push_back(1);
+  for (uint32_t v = 1; v < nodes.size(); v = nodes[v].end)
+    if (nodes[v].end - shards.back() >= target ||
+        nodes[v].end == nodes.size())
+      shards.push_back(nodes[v].end);
+  if (shards.size() == 1)
+    shards.push_back(nodes.size()); // Only the root, searched in shard 0.
+}
+
+inline void
+fuzzy_dictionary::search_shard(const std::string &query, size_t k,
+                               size_t shard, std::vector<uint64_t> &state,
+                               std::vector<fuzzy_match_t> &matches) const {
+  const size_t m = query.length();
+  const size_t W = (m + 1 + 63) / 64; // Bits 0 ... m.
+  const size_t E = k + 1;
+  const uint64_t last_mask =
+      (m + 1) % 64 ? (uint64_t(1) << ((m + 1) % 64)) - 1 : ~uint64_t(0);
+
+  // eq[c * W + w]: bit i + 1 set iff query[i] == c.
+  std::vector<uint64_t> eq(256 * W, 0);
+  for (size_t i = 0; i < m; ++i)
+    eq[static_cast<unsigned char>(query[i]) * W + (i + 1) / 64] |=
+        uint64_t(1) << ((i + 1) % 64);
+
+  // state[(d * E + e) * W + w]: R[e] at depth d. At depth 0, bits 0 ... e.
+  state.assign((max_depth + 1) * E * W, 0);
+  for (size_t e = 0; e < E; ++e)
+    for (size_t i = 0; i <= std::min(e, m); ++i)
+      state[e * W + i / 64] |= uint64_t(1) << (i % 64);
+
+  auto report = [&](uint32_t v, const uint64_t *R) {
+    const node_t &n = nodes[v];
+    if (n.words_begin == n.words_end)
+      return;
+    for (size_t e = 0; e < E; ++e)
+      if (R[e * W + m / 64] >> (m % 64) & 1) {
+        for (auto s = n.words_begin; s < n.words_end; ++s)
+          matches.push_back({sorted[s], static_cast<uint32_t>(e)});
+        return;
+      }
+  };
+  if (shard == 0)
+    report(0, state.data());
+
+  for (uint32_t v = shards[shard]; v < shards[shard + 1];) {
+    const node_t &n = nodes[v];
+    const uint64_t *P = &state[(n.depth - 1) * E * W];
+    uint64_t *R = &state[n.depth * E * W];
+    const uint64_t *B = &eq[static_cast<unsigned char>(n.c) * W];
+    uint64_t alive = 0;
+    for (size_t e = 0; e < E; ++e) {
+      uint64_t carry = 0, carry_prev = 0, carry_new = 0;
+      for (size_t w = 0; w < W; ++w) {
+        const uint64_t p = P[e * W + w];
+        // Match: query prefix i and trie prefix both one longer.
+        uint64_t r = ((p << 1) | carry) & B[w];
+        carry = p >> 63;
+        if (e) {
+          const uint64_t pe = P[(e - 1) * W + w], re = R[(e - 1) * W + w];
+          // Within e - 1 already, a trie character inserted, a character
+          // replaced, a query character deleted.
+          r |= re | pe | (pe << 1) | carry_prev | (re << 1) | carry_new;
+          carry_prev = pe >> 63;
+          carry_new = re >> 63;
+        }
+        if (w == W - 1)
+          r &= last_mask;
+        R[e * W + w] = r;
+        alive |= r;
+      }
+    }
+    if (!alive) {
+      v = n.end; // Nothing below is within k.
+      continue;
+    }
+    report(v, R);
+    ++v;
+  }
+}
+
+inline void fuzzy_dictionary::search(const std::string &query, size_t k,
+                                     std::vector<fuzzy_match_t> &matches,
+                                     size_t nthreads) const {
+  std::vector<std::vector<fuzzy_match_t>> batch;
+  search_batch({query}, k, batch, nthreads);
+  matches = std::move(batch[0]);
+}
+
+inline void fuzzy_dictionary::search_batch(
+    const std::vector<std::string> &queries, size_t k,
+    std::vector<std::vector<fuzzy_match_t>> &matches, size_t nthreads) const {
+  const size_t S = shards.size() - 1, tasks = queries.size() * S;
+  // Per task, so that the merge does not depend on the threads.
+  std::vector<std::vector<fuzzy_match_t>> found(tasks);
+  std::atomic<size_t> next(0);
+  auto work = [&]() {
+    std::vector<uint64_t> state;
+    for (size_t t; (t = next++) < tasks;)
+      search_shard(queries[t / S], k, t % S, state, found[t]);
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < nthreads; ++t)
+    workers.emplace_back(work);
+  work();
+  for (auto &w : workers)
+    w.join();
+
+  matches.assign(queries.size(), {});
+  for (size_t t = 0; t < tasks; ++t)
+    matches[t / S].insert(matches[t / S].end(), found[t].begin(),
+                          found[t].end());
+  for (auto &mq : matches)
+    std::sort(mq.begin(), mq.end());
+}
@@ -0,0 +1,601 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "wavefront.hpp"
+
+// Tiles of knapsack_wavefront: a few items by many capacities, so that the
+// rows kept for the tiles in flight stay small.
+#define KNAPSACK_TILE_ROWS 16
+#define KNAPSACK_TILE_COLS 4096
+
+// Items around the break item solved exactly by knapsack_core, and the
+// nodes its search may visit.
+#define KNAPSACK_CORE_ITEMS 64
+#define KNAPSACK_CORE_NODES (1 << 20)
+
+// Shortest dependency distance handed to the relax kernel; shorter ones are
+// updated inline, one capacity at a time.
+#define KNAPSACK_RELAX_MIN 8
+
+struct item_t {
+  size_t weight;
+  size_t profit;
+};
+
+// An item of the knapsack with both a weight and a volume capacity.
+struct item2_t {
+  size_t weight;
+  size_t volume;
+  size_t profit;
+};
+
+inline size_t rand_num(size_t from, size_t to) {
+  return from + rand() % (to - from);
+}
+
+// Columns [c0, c1] of a row of the binary knapsack DP,
+// cur[w] = max(prev[w], prev[w - weight] + profit).
+typedef void (*knapsack_row_kernel_t)(const uint32_t *prev, uint32_t *cur,
+                                      size_t c0, size_t c1, size_t weight,
+                                      uint32_t profit);
+
+namespace knapsack_util {
+inline void knapsack_row_scalar(const uint32_t *prev, uint32_t *cur,
+                                size_t c0, size_t c1, size_t weight,
+                                uint32_t profit) {
+  size_t w = c0;
+  for (; w <= c1 && w < weight; ++w)
+    cur[w] = prev[w];
+  for (; w <= c1; ++w)
+    cur[w] = std::max(prev[w], prev[w - weight] + profit);
+}
+
+__attribute__((target("avx2"))) inline void
+knapsack_row_avx2(const uint32_t *prev, uint32_t *cur, size_t c0, size_t c1,
+                  size_t weight, uint32_t profit) {
+  size_t w = c0;
+  for (; w <= c1 && w < weight; ++w)
+    cur[w] = prev[w];
+  const __m256i p = _mm256_set1_epi32(profit);
+  for (; w + 8 <= c1 + 1; w += 8) {
+    const __m256i skip =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev + w));
+    const __m256i take = _mm256_add_epi32(
+        _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(prev + w - weight)),
+        p);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(cur + w),
+                        _mm256_max_epu32(skip, take));
+  }
+  for (; w <= c1; ++w)
+    cur[w] = std::max(prev[w], prev[w - weight] + profit);
+}
+} // namespace knapsack_util
+
+// The fastest row kernel the CPU supports.
+inline knapsack_row_kernel_t select_knapsack_row_kernel() {
+  if (__builtin_cpu_supports("avx2"))
+    return knapsack_util::knapsack_row_avx2;
+  return knapsack_util::knapsack_row_scalar;
+}
+
+// Max profit of items[0 ... N - 1] for every capacity 0 ... S in a single
+// row: updating capacities from the right, best[w - weight] still holds
+// the value without the item when best[w] reads it.
+template <typename T>
+void knapsack_profits(size_t S, const item_t *items, size_t N,
+                      std::vector<T> &best) {
+  best.assign(S + 1, 0);
+  for (size_t n = 0; n < N; ++n) {
+    const size_t weight = items[n].weight;
+    const T profit = static_cast<T>(items[n].profit);
+    for (size_t w = S + 1; w-- > weight;)
+      best[w] = std::max(best[w], static_cast<T>(best[w - weight] + profit));
+  }
+}
+
+namespace knapsack_util {
+// Whether profits fit in 32 bits, halving the memory of the rows.
+inline bool narrow_profits(const item_t *items, size_t N) {
+  size_t total = 0;
+  for (size_t n = 0; n < N; ++n)
+    total += items[n].profit;
+  return total <= UINT32_MAX;
+}
+
+// Hirschberg's divide and conquer on items: the best split of capacity cap
+// between items [lo, mid) and [mid, hi) is found from one row for each
+// half, then both halves are solved alone. The rows are reused at every
+// level, so space stays O(S); each level costs at most half the time of
+// the one above, so time stays O(N S).
+template <typename T>
+void select_items(const item_t *items, size_t lo, size_t hi, size_t cap,
+                  std::vector<T> &first, std::vector<T> &second,
+                  std::vector<size_t> &chosen) {
+  if (hi - lo == 1) {
+    if (items[lo].weight <= cap && items[lo].profit > 0)
+      chosen.push_back(lo);
+    return;
+  }
+  if (hi == lo)
+    return;
+
+  const size_t mid = lo + (hi - lo) / 2;
+  knapsack_profits(cap, items + lo, mid - lo, first);
+  knapsack_profits(cap, items + mid, hi - mid, second);
+  size_t split = 0;
+  for (size_t c = 1; c <= cap; ++c)
+    if (first[c] + second[cap - c] > first[split] + second[cap - split])
+      split = c;
+
+  select_items(items, lo, mid, split, first, second, chosen);
+  select_items(items, mid, hi, cap - split, first, second, chosen);
+}
+} // namespace knapsack_util
+
+// Max profit of the binary knapsack of capacity S in O(S) space.
+inline size_t knapsack_max_profit(size_t S, const item_t *items, size_t N) {
+  if (knapsack_util::narrow_profits(items, N)) {
+    std::vector<uint32_t> best;
+    knapsack_profits(S, items, N, best);
+    return best[S];
+  }
+  std::vector<size_t> best;
+  knapsack_profits(S, items, N, best);
+  return best[S];
+}
+
+// An optimal item set, in increasing index order, and its profit, in O(S)
+// space beside the items.
+inline size_t knapsack_items(size_t S, const item_t *items, size_t N,
+                             std::vector<size_t> &chosen) {
+  chosen.clear();
+  if (knapsack_util::narrow_profits(items, N)) {
+    std::vector<uint32_t> first, second;
+    knapsack_util::select_items(items, 0, N, S, first, second, chosen);
+  } else {
+    std::vector<size_t> first, second;
+    knapsack_util::select_items(items, 0, N, S, first, second, chosen);
+  }
+  size_t profit = 0;
+  for (auto n : chosen)
+    profit += items[n].profit;
+  return profit;
+}
+
+// The total weights of all the subsets of items, up to S, as a bitset:
+// adding an item ors the set with itself shifted by the item's weight, 64
+// sums per word operation, from the high words down as in
+// knapsack_profits.
+class subset_sums {
+private:
+  const size_t S;
+  std::vector<uint64_t> bits;
+
+public:
+  subset_sums(size_t _S, const item_t *items, size_t N)
+      : S(_S), bits(_S / 64 + 1, 0) {
+    bits[0] = 1; // The empty set.
+    const size_t top = S / 64;
+    const uint64_t top_mask =
+        (S + 1) % 64 ? (uint64_t(1) << ((S + 1) % 64)) - 1 : ~uint64_t(0);
+    for (size_t n = 0; n < N; ++n) {
+      const size_t weight = items[n].weight;
+      if (weight > S)
+        continue;
+      const size_t words = weight / 64, shift = weight % 64;
+      for (size_t i = top + 1; i-- > words;) {
+        uint64_t v = bits[i - words] << shift;
+        if (shift && i > words)
+          v |= bits[i - words - 1] >> (64 - shift);
+        bits[i] |= v;
+      }
+      bits[top] &= top_mask;
+    }
+  }
+
+  // Whether some subset weighs exactly c.
+  bool reachable(size_t c) const {
+    return c <= S && (bits[c / 64] >> (c % 64) & 1);
+  }
+
+  // The heaviest subset within S.
+  size_t max_fill() const {
+    for (size_t i = bits.size(); i-- > 0;)
+      if (bits[i])
+        return i * 64 + 63 - __builtin_clzll(bits[i]);
+    return 0;
+  }
+};
+
+// Max profit of the binary knapsack of capacity S, with the table of
+// knapsack_dp cut in KNAPSACK_TILE_ROWS x KNAPSACK_TILE_COLS tiles run by
+// wavefront on nthreads threads.
+// Row n reads row n - 1 anywhere to its left, which may lie in any earlier
+// tile of the row of tiles; all the rows of the rows of tiles in flight are
+// kept in a ring. A row of tiles is done TC anti-diagonals after it starts,
+// so with TC tiles a row, a ring of TC + 2 rows of tiles is never
+// overwritten while read. The rows are uint32; when the profits may not
+// fit, knapsack_max_profit's 64-bit row runs instead, on one thread.
+// The ring holds (TC + 2) x KNAPSACK_TILE_ROWS full rows, about S^2 / 64
+// bytes: 48 MB at S = 50K but 15 GB at S = 1M. Every row of a tile, not
+// only its last, is read by the tiles to its right, so the ring cannot be
+// cut to tile boundaries; for large capacities use knapsack_parallel, whose
+// two rows take O(S).
+inline size_t knapsack_wavefront(size_t S, const item_t *items, size_t N,
+                                 size_t nthreads,
+                                 knapsack_row_kernel_t kernel =
+                                     select_knapsack_row_kernel()) {
+  if (!knapsack_util::narrow_profits(items, N))
+    return knapsack_max_profit(S, items, N);
+  const size_t TH = KNAPSACK_TILE_ROWS, TW = KNAPSACK_TILE_COLS;
+  const size_t TR = (N + TH - 1) / TH, TC = (S + TW) / TW;
+  const size_t R = (TC + 2) * TH;
+  // Row n of the DP, n = 0 ... N; row 0 has no items.
+  std::vector<uint32_t> ring(R * (S + 1), 0);
+  auto row = [&](size_t n) { return &ring[(n % R) * (S + 1)]; };
+
+  wavefront(TR, TC, nthreads, [&](size_t ti, size_t tj) {
+    const size_t n1 = std::min(N, (ti + 1) * TH);
+    const size_t c0 = tj * TW, c1 = std::min(S, c0 + TW - 1);
+    for (size_t n = ti * TH + 1; n <= n1; ++n)
+      kernel(row(n - 1), row(n), c0, c1, items[n - 1].weight,
+             items[n - 1].profit);
+  });
+  return row(N)[S];
+}
+
+// Max profit of the binary knapsack of capacity S, with each row of the DP
+// split in nthreads ranges of capacities. A row reads only the row before,
+// so the ranges are independent; a barrier separates the items.
+inline size_t knapsack_parallel(size_t S, const item_t *items, size_t N,
+                                size_t nthreads,
+                                knapsack_row_kernel_t kernel =
+                                    select_knapsack_row_kernel()) {
+  if (!knapsack_util::narrow_profits(items, N))
+    return knapsack_max_profit(S, items, N);
+  nthreads = std::max<size_t>(1, std::min(nthreads, S + 1));
+  std::vector<uint32_t> rows(2 * (S + 1), 0);
+  uint32_t *prev = rows.data(), *cur = prev + S + 1;
+  wavefront_barrier barrier(nthreads);
+  auto work = [&](size_t t) {
+    const size_t c0 = (S + 1) * t / nthreads;
+    const size_t c1 = (S + 1) * (t + 1) / nthreads - 1;
+    for (size_t n = 0; n < N; ++n) {
+      kernel(prev, cur, c0, c1, items[n].weight, items[n].profit);
+      barrier.arrive_and_wait([&] { std::swap(prev, cur); });
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < nthreads; ++t)
+    workers.emplace_back(work, t);
+  work(0);
+  for (auto &w : workers)
+    w.join();
+  return prev[S];
+}
+
+namespace knapsack_util {
+// Item indices by decreasing profit per weight, lighter first on ties.
+inline std::vector<size_t> by_efficiency(const item_t *items, size_t N) {
+  std::vector<size_t> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const size_t pa = items[a].profit * items[b].weight;
+    const size_t pb = items[b].profit * items[a].weight;
+    return pa != pb ? pa > pb : items[a].weight < items[b].weight;
+  });
+  return order;
+}
+
+// Depth-first branch and bound over items[order[0]], items[order[1]] ...
+// in decreasing efficiency, taking each item before leaving it out. A node
+// is cut when Dantzig's bound, the fractional greedy fill of the capacity
+// left, is no better than the best solution found. With efficiencies
+// decreasing, the greedy fill takes the items up to the break item, found
+// on prefix sums, and a fraction of the break item.
+class branch_bound {
+private:
+  const item_t *items;
+  const size_t *order;
+  const size_t N;
+  std::vector<size_t> W, P; // Prefix sums of the weights and profits.
+  std::vector<bool> x;      // x[i]: items[order[i]] taken.
+  size_t nodes_left;
+
+  size_t bound(size_t i, size_t cap) const {
+    const size_t b =
+        std::upper_bound(W.begin() + i + 1, W.end(), W[i] + cap) - W.begin() -
+        1;
+    size_t profit = P[b] - P[i];
+    if (b < N)
+      profit += (cap - (W[b] - W[i])) * items[order[b]].profit /
+                items[order[b]].weight;
+    return profit;
+  }
+
+  void search(size_t i, size_t cap, size_t profit) {
+    if (!nodes_left) {
+      optimal = false;
+      return;
+    }
+    --nodes_left;
+    if (profit > best) {
+      best = profit;
+      best_x = x;
+    }
+    if (i == N || profit + bound(i, cap) <= best)
+      return;
+    const item_t &item = items[order[i]];
+    if (item.weight <= cap) {
+      x[i] = true;
+      search(i + 1, cap - item.weight, profit + item.profit);
+      x[i] = false;
+    }
+    search(i + 1, cap, profit);
+  }
+
+public:
+  size_t best = 0;
+  std::vector<bool> best_x;
+  bool optimal = true; // The search ended within max_nodes.
+
+  branch_bound(const item_t *_items, const size_t *_order, size_t _N,
+               size_t max_nodes)
+      : items(_items), order(_order), N(_N), W(_N + 1, 0), P(_N + 1, 0),
+        x(_N, false), nodes_left(max_nodes), best_x(_N, false) {
+    for (size_t i = 0; i < N; ++i) {
+      W[i + 1] = W[i] + items[order[i]].weight;
+      P[i + 1] = P[i] + items[order[i]].profit;
+    }
+  }
+
+  void run(size_t S) { search(0, S, 0); }
+};
+
+// The items of the greedy fill before the core, where the break item is
+// the first that does not fit, and a branch_bound solution of the core of
+// KNAPSACK_CORE_ITEMS items around it; flags by position in order.
+inline size_t core_solution(size_t S, const item_t *items,
+                            const std::vector<size_t> &order,
+                            std::vector<bool> &x) {
+  const size_t N = order.size();
+  size_t b = 0, weight = 0, profit = 0;
+  while (b < N && weight + items[order[b]].weight <= S)
+    weight += items[order[b++]].weight;
+  const size_t lo = b > KNAPSACK_CORE_ITEMS / 2 ? b - KNAPSACK_CORE_ITEMS / 2
+                                                 : 0;
+  const size_t hi = std::min(N, lo + KNAPSACK_CORE_ITEMS);
+
+  x.assign(N, false);
+  weight = 0;
+  for (size_t i = 0; i < lo; ++i) {
+    x[i] = true;
+    weight += items[order[i]].weight;
+    profit += items[order[i]].profit;
+  }
+  branch_bound core(items, order.data() + lo, hi - lo, KNAPSACK_CORE_NODES);
+  core.run(S - weight);
+  for (size_t i = lo; i < hi; ++i)
+    x[i] = core.best_x[i - lo];
+  return profit + core.best;
+}
+
+inline void chosen_items(const std::vector<size_t> &order,
+                         const std::vector<bool> &x,
+                         std::vector<size_t> &chosen) {
+  chosen.clear();
+  for (size_t i = 0; i < order.size(); ++i)
+    if (x[i])
+      chosen.push_back(order[i]);
+  std::sort(chosen.begin(), chosen.end());
+}
+} // namespace knapsack_util
+
+// A good item set, in increasing index order, and its profit, by the core
+// heuristic: the items far from the break item of the greedy fill are
+// rarely other than greedy, so only the core around it is searched. Time
+// does not depend on S.
+inline size_t knapsack_core(size_t S, const item_t *items, size_t N,
+                            std::vector<size_t> &chosen) {
+  const std::vector<size_t> order = knapsack_util::by_efficiency(items, N);
+  std::vector<bool> x;
+  const size_t profit = knapsack_util::core_solution(S, items, order, x);
+  knapsack_util::chosen_items(order, x, chosen);
+  return profit;
+}
+
+// An item set, in increasing index order, and its profit, by branch and
+// bound from the core solution. The search stops after max_nodes nodes;
+// optimal tells whether it ended before, proving the set optimal.
+inline size_t knapsack_branch_bound(size_t S, const item_t *items, size_t N,
+                                    std::vector<size_t> &chosen,
+                                    size_t max_nodes, bool &optimal) {
+  const std::vector<size_t> order = knapsack_util::by_efficiency(items, N);
+  knapsack_util::branch_bound bb(items, order.data(), N, max_nodes);
+  bb.best = knapsack_util::core_solution(S, items, order, bb.best_x);
+  bb.run(S);
+  optimal = bb.optimal;
+  knapsack_util::chosen_items(order, bb.best_x, chosen);
+  return bb.best;
+}
+
+// An optimal item set, in increasing index order, and its profit, by
+// branch and bound.
+inline size_t knapsack_branch_bound(size_t S, const item_t *items, size_t N,
+                                    std::vector<size_t> &chosen) {
+  bool optimal;
+  return knapsack_branch_bound(S, items, N, chosen, SIZE_MAX, optimal);
+}
+
+// dst[i] = max(dst[i], src[i] + profit) for i < n, on contiguous rows; every
+// DP row update below is a run of these.
+typedef void (*knapsack_relax_kernel_t)(const uint32_t *src, uint32_t *dst,
+                                        size_t n, uint32_t profit);
+
+namespace knapsack_util {
+template <typename T>
+void relax_scalar(const T *src, T *dst, size_t n, T profit) {
+  for (size_t i = 0; i < n; ++i)
+    dst[i] = std::max(dst[i], static_cast<T>(src[i] + profit));
+}
+
+__attribute__((target("avx2"))) inline void
+relax_avx2(const uint32_t *src, uint32_t *dst, size_t n, uint32_t profit) {
+  const __m256i p = _mm256_set1_epi32(profit);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i take = _mm256_add_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), p);
+    const __m256i skip =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_max_epu32(skip, take));
+  }
+  for (; i < n; ++i)
+    dst[i] = std::max(dst[i], src[i] + profit);
+}
+
+// best[w] = max(best[w], best[w - weight] + profit) for w = S ... weight,
+// in place on a row of S + 1: chunks of weight capacities from the right
+// read only capacities left of the chunk, not yet updated.
+template <typename T, typename RELAX>
+void zero_one_update(T *best, size_t S, size_t weight, T profit,
+                     RELAX relax) {
+  if (weight && weight < KNAPSACK_RELAX_MIN) {
+    for (size_t w = S + 1; w-- > weight;)
+      best[w] = std::max(best[w], static_cast<T>(best[w - weight] + profit));
+    return;
+  }
+  for (size_t hi = S + 1; hi > weight;) {
+    const size_t lo = weight ? std::max(weight, hi - weight) : 0;
+    relax(best + lo - weight, best + lo, hi - lo, profit);
+    hi = lo;
+  }
+}
+
+// The same for w = weight ... S, taking the item any number of times:
+// chunks of weight capacities from the left read only capacities left of
+// the chunk, already updated. weight > 0.
+template <typename T, typename RELAX>
+void unbounded_update(T *best, size_t S, size_t weight, T profit,
+                      RELAX relax) {
+  if (weight < KNAPSACK_RELAX_MIN) {
+    for (size_t w = weight; w <= S; ++w)
+      best[w] = std::max(best[w], static_cast<T>(best[w - weight] + profit));
+    return;
+  }
+  for (size_t lo = weight; lo <= S; lo += weight)
+    relax(best + lo - weight, best + lo, std::min(weight, S + 1 - lo),
+          profit);
+}
+
+// Whether no knapsack of these items can exceed 32 bits of profit, taking
+// each item as many times as fits, or once.
+template <typename ITEM>
+bool narrow_bound(const ITEM *items, size_t N, size_t S, bool unbounded) {
+  size_t total = 0;
+  for (size_t n = 0; n < N && total <= UINT32_MAX; ++n) {
+    const size_t copies = unbounded ? S / items[n].weight : 1;
+    total += copies * items[n].profit;
+  }
+  return total <= UINT32_MAX;
+}
+
+template <typename T, typename RELAX>
+T unbounded_profits(size_t S, const item_t *items, size_t N, RELAX relax) {
+  std::vector<T> best(S + 1, 0);
+  for (size_t n = 0; n < N; ++n)
+    unbounded_update(best.data(), S, items[n].weight,
+                     static_cast<T>(items[n].profit), relax);
+  return best[S];
+}
+
+// The (S + 1) x (V + 1) table of the best profit of each weight and volume
+// capacity, row w for weight w. An item of weight wi moves row w - wi, at
+// volumes shifted by its volume, into row w: from the bottom up for the
+// binary knapsack, so that row w - wi is still without the item, and from
+// the top down for the unbounded one, so that it already has all its
+// copies. Items of weight 0, binary only, update each row alone.
+template <typename T, typename RELAX>
+T profits_2d(size_t S, size_t V, const item2_t *items, size_t N,
+             bool unbounded, RELAX relax) {
+  std::vector<T> table((S + 1) * (V + 1), 0);
+  auto row = [&](size_t w) { return &table[w * (V + 1)]; };
+  for (size_t n = 0; n < N; ++n) {
+    const size_t wi = items[n].weight, vi = items[n].volume;
+    const T profit = static_cast<T>(items[n].profit);
+    if (wi > S || vi > V)
+      continue;
+    if (!wi) {
+      for (size_t w = 0; w <= S; ++w)
+        zero_one_update(row(w), V, vi, profit, relax);
+    } else if (unbounded) {
+      for (size_t w = wi; w <= S; ++w)
+        relax(row(w - wi), row(w) + vi, V + 1 - vi, profit);
+    } else {
+      for (size_t w = S + 1; w-- > wi;)
+        relax(row(w - wi), row(w) + vi, V + 1 - vi, profit);
+    }
+  }
+  return row(S)[V];
+}
+} // namespace knapsack_util
+
+// The fastest relax kernel the CPU supports.
+inline knapsack_relax_kernel_t select_knapsack_relax_kernel() {
+  if (__builtin_cpu_supports("avx2"))
+    return knapsack_util::relax_avx2;
+  return knapsack_util::relax_scalar<uint32_t>;
+}
+
+// Max profit of the unbounded knapsack of capacity S, each item taken any
+// number of times, in one row. Items need a positive weight. Rows are
+// uint32 run by kernel when the profit is sure to fit, else 64-bit scalar.
+inline size_t knapsack_unbounded(size_t S, const item_t *items, size_t N,
+                                 knapsack_relax_kernel_t kernel =
+                                     select_knapsack_relax_kernel()) {
+  if (knapsack_util::narrow_bound(items, N, S, true))
+    return knapsack_util::unbounded_profits<uint32_t>(S, items, N, kernel);
+  return knapsack_util::unbounded_profits<size_t>(
+      S, items, N, knapsack_util::relax_scalar<size_t>);
+}
+
+// Max profit of the binary knapsack of weight capacity S and volume
+// capacity V.
+inline size_t knapsack_2d(size_t S, size_t V, const item2_t *items, size_t N,
+                          knapsack_relax_kernel_t kernel =
+                              select_knapsack_relax_kernel()) {
+  if (knapsack_util::narrow_bound(items, N, S, false))
+    return knapsack_util::profits_2d<uint32_t>(S, V, items, N, false, kernel);
+  return knapsack_util::profits_2d<size_t>(
+      S, V, items, N, false, knapsack_util::relax_scalar<size_t>);
+}
+
+// The same, each item taken any number of times. Items need a positive
+// weight.
+inline size_t knapsack_2d_unbounded(size_t S, size_t V, const item2_t *items,
+                                    size_t N,
+                                    knapsack_relax_kernel_t kernel =
+                                        select_knapsack_relax_kernel()) {
+  if (knapsack_util::narrow_bound(items, N, S, true))
+    return knapsack_util::profits_2d<uint32_t>(S, V, items, N, true, kernel);
+  return knapsack_util::profits_2d<size_t>(
+      S, V, items, N, true, knapsack_util::relax_scalar<size_t>);
+}
@@ -9,13 +9,7 @@
 #include <iostream>
 #include <string>
 
-// Cost of multiplying 2 matrices of dimensions d1 X d2 and d2 X d3.
-size_t mult_cost(size_t d1, size_t d2, size_t d3) {
-  // In brute force matrix multiplication, calculation of each element of the
-  // product requires d2 multiplications and the product is of d1 X d3
-  // dimension.
-  return (d1 * d2 * d3);
-}
+#include "matrix_chain.hpp"
 
 // Recursively build the parenthesized string following the pivots.
 std::string parenthesize(size_t *pivot, size_t N, int i, int j) {
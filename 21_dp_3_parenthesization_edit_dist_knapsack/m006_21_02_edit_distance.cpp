@@ -9,34 +9,7 @@
 #include <iostream>
 #include <string>
 
-#define INFINITE 0x1FFFFFFF
-
-// Types of operations.
-enum transform_op_t { NOOP, INSERT, DELETE, REPLACE };
-
-std::ostream &operator<<(std::ostream &os, const transform_op_t &op) {
-  switch (op) {
-  case INSERT:
-    os << 'I';
-    break;
-  case DELETE:
-    os << 'D';
-    break;
-  case NOOP:
-    os << '.';
-    break;
-  case REPLACE:
-    os << 'R';
-    break;
-  default:
-    os << 'X';
-    break;
-  }
-
-  return os;
-}
-
-typedef size_t (&cost_func_t)(char, char, transform_op_t);
+#include "edit_distance.hpp"
 
 // Least cost operations to transform x into y.
 void edit_distance_dp(const std::string &x, const std::string &y,
@@ -141,38 +114,6 @@ void edit_distance_dp(const std::string &x, const std::string &y,
   }
 }
 
-size_t edit_cost(char c1, char c2, transform_op_t op) {
-  switch (op) {
-  case INSERT:
-  case DELETE:
-    return 1;
-  case NOOP:
-    return (c1 == c2) ? 0 : INFINITE;
-  case REPLACE:
-    return (c1 == c2) ? INFINITE : 1;
-  default:
-    break;
-  }
-
-  return INFINITE;
-}
-
-size_t edit_cost_noreplace(char c1, char c2, transform_op_t op) {
-  switch (op) {
-  case INSERT:
-  case DELETE:
-    return 1;
-  case NOOP:
-    return (c1 == c2) ? 0 : INFINITE;
-  case REPLACE:
-    return INFINITE;
-  default:
-    break;
-  }
-
-  return INFINITE;
-}
-
 int main() {
 
   std::string x = "HELLO", y = "YELLOW";
@@ -10,17 +10,14 @@
 #include <iostream>
 #include <string>
 
+#include "knapsack.hpp"
+
 #define MIN_WEIGHT 1
 #define MAX_WEIGHT 10
 
 #define MIN_PROFIT 1
 #define MAX_PROFIT 100
 
-struct item_t {
-  size_t weight;
-  size_t profit;
-};
-
 void knapsack_dp(size_t S, const item_t *items, size_t N) {
   size_t max_profit[N + 1][S + 1];
 
@@ -63,8 +60,6 @@ void knapsack_dp(size_t S, const item_t *items, size_t N) {
 
 }
 
-size_t rand_num(size_t from, size_t to) { return from + rand() % (to - from); }
-
 int main() {
 
   constexpr size_t N = 10; // Number of items.
@@ -0,0 +1,109 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "matrix_chain.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Largest chain for the exact DP: O(N^3) time, 20 * N^2 / 2 bytes.
+#define EXACT_MAX_N 2000
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Recursive reference: the parenthesization of dp_matrix_chain_mult_order.
+std::string parenthesize_recursive(const chain_table &t, size_t i, size_t j) {
+  if (i == j)
+    return std::string("A") + std::to_string(i);
+  auto k = t.pivot(i, j);
+  return std::string("(") + parenthesize_recursive(t, i, k - 1) + " " +
+         parenthesize_recursive(t, k, j) + ")";
+}
+
+void print_cell(double v) {
+  std::cout.width(12);
+  if (v < 0)
+    std::cout << "-";
+  else
+    std::cout << v;
+}
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  // Small demo; the iterative builder gives the recursive string.
+  {
+    const size_t N = 10;
+    std::vector<size_t> dimension(N + 1);
+    for (auto &d : dimension)
+      d = 1 + rand() % 20;
+    chain_table t(N);
+    matrix_chain_dp(dimension.data(), N, t);
+    auto order = t.order();
+    std::cout << "Optimal Multiplication Order: " << std::endl
+              << parenthesize(order) << std::endl;
+    if (parenthesize(order) != parenthesize_recursive(t, 0, N - 1)) {
+      std::cout << "MISMATCH" << std::endl;
+      return 1;
+    }
+    std::cout << std::endl;
+  }
+
+  bool ok = true;
+  std::cout << "Time (ms) and cost relative to the optimum" << std::endl;
+  std::cout << "  dimensions        N       exact        chin    chin/exact"
+            << std::endl;
+  const size_t sizes[] = {100, 500, 2000, 10000, 100000};
+  for (size_t run = 0; run < 10; ++run) {
+    const size_t N = sizes[run / 2];
+    const size_t min_dim = run % 2 ? 500 : 1;
+    // Dimensions in [min_dim, 1000].
+    std::vector<size_t> dimension(N + 1);
+    for (auto &d : dimension)
+      d = min_dim + rand() % (1001 - min_dim);
+
+    double t_exact = -1;
+    size_t c_exact = SIZE_MAX;
+    if (N <= EXACT_MAX_N) {
+      auto t = std::chrono::high_resolution_clock::now();
+      chain_table table(N);
+      c_exact = matrix_chain_dp(dimension.data(), N, table);
+      auto order = table.order();
+      t_exact = elapsed_ms(t);
+      ok = ok && chain_cost(order, dimension.data()) == c_exact;
+    }
+    auto t = std::chrono::high_resolution_clock::now();
+    auto order = matrix_chain_chin(dimension.data(), N);
+    double t_chin = elapsed_ms(t);
+    size_t c_chin = chain_cost(order, dimension.data());
+    ok = ok && (c_exact == SIZE_MAX || c_chin >= c_exact);
+
+    std::cout.width(7);
+    std::cout << min_dim << "-1000";
+    std::cout.width(9);
+    std::cout << N;
+    print_cell(t_exact);
+    print_cell(t_chin);
+    std::cout.width(14);
+    if (c_exact != SIZE_MAX)
+      std::cout << static_cast<double>(c_chin) / c_exact;
+    else
+      std::cout << "-";
+    std::cout << std::endl;
+  }
+
+  std::cout << (ok ? "Costs consistent" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
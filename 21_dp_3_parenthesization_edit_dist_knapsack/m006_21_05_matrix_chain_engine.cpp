@@ -0,0 +1,123 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "matrix_chain.hpp"
+#include "matrix_engine.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+#define CHAIN_LENGTH 16
+#define MIN_DIMENSION 4
+#define MAX_DIMENSION 320
+#define REPEATS 3 // Best of, with the buffer pool warm after the first.
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Largest difference relative to the largest element.
+double relative_error(const matrix_t &x, const matrix_t &y) {
+  double diff = 0, scale = 0;
+  for (size_t i = 0; i < x.data.size(); ++i) {
+    diff = std::max(diff, std::fabs(x.data[i] - y.data[i]));
+    scale = std::max(scale, std::fabs(x.data[i]));
+  }
+  return scale ? diff / scale : diff;
+}
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  const size_t N = CHAIN_LENGTH;
+  std::vector<size_t> dimension(N + 1);
+  for (auto &d : dimension)
+    d = MIN_DIMENSION + rand() % (MAX_DIMENSION - MIN_DIMENSION + 1);
+
+  std::vector<matrix_t> chain;
+  for (size_t i = 0; i < N; ++i) {
+    chain.emplace_back(dimension[i], dimension[i + 1]);
+    for (auto &v : chain.back().data)
+      v = 2.0 * rand() / RAND_MAX - 1.0;
+  }
+
+  std::cout << "Dimensions:";
+  for (auto d : dimension)
+    std::cout << " " << d;
+  std::cout << std::endl;
+
+  chain_table table(N);
+  matrix_chain_dp(dimension.data(), N, table);
+  // Pivot j multiplies A_i ... A_j-1 by A_j: left to right.
+  const std::vector<std::pair<std::string, chain_order_t>> orders = {
+      {"optimal", table.order()},
+      {"left-to-right", chain_order_from_pivots(
+                            N, [](uint32_t, uint32_t j) { return j; })}};
+  std::cout << "Optimal Multiplication Order: " << std::endl
+            << parenthesize(orders[0].second) << std::endl
+            << std::endl;
+
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  const std::vector<std::pair<std::string, gemm_kernel_t>> kernels = {
+      {"scalar", matrix_engine_util::gemm_scalar},
+      {"best", select_gemm_kernel()}};
+
+  std::cout << "Time (ms), and ns per multiplication of the mult_cost model"
+            << std::endl;
+  std::cout << "        order     mult_cost   kernel  threads        ms"
+            << "   ns/mult" << std::endl;
+  matrix_t reference;
+  double worst_error = 0;
+  for (const auto &order : orders) {
+    const size_t cost = chain_cost(order.second, dimension.data());
+    for (const auto &kernel : kernels) {
+      for (size_t nthreads : {size_t(1), hw}) {
+        chain_multiplier engine(nthreads, kernel.second);
+        double best_ms = 0;
+        matrix_t product;
+        for (size_t r = 0; r < REPEATS; ++r) {
+          auto t = std::chrono::high_resolution_clock::now();
+          product = engine.multiply(chain, order.second);
+          double ms = elapsed_ms(t);
+          best_ms = r ? std::min(best_ms, ms) : ms;
+        }
+        if (reference.data.empty())
+          reference = product;
+        worst_error = std::max(worst_error, relative_error(reference, product));
+
+        std::cout.width(13);
+        std::cout << order.first;
+        std::cout.width(14);
+        std::cout << cost;
+        std::cout.width(9);
+        std::cout << kernel.first;
+        std::cout.width(9);
+        std::cout << nthreads;
+        std::cout.width(10);
+        std::cout << best_ms;
+        std::cout.width(10);
+        std::cout << best_ms * 1e6 / cost << std::endl;
+        if (hw == 1)
+          break;
+      }
+    }
+  }
+
+  std::cout << "Largest relative difference between products: " << worst_error
+            << std::endl;
+  bool ok = worst_error < 1e-9;
+  std::cout << (ok ? "Products match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
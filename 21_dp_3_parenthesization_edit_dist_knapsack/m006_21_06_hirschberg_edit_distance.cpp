@@ -0,0 +1,126 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "edit_distance.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+#define DEFAULT_LENGTH 3000
+#define RANDOM_TESTS 100
+#define MAX_TEST_LENGTH 400
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+std::string random_string(size_t n) {
+  std::string s(n, 'A');
+  for (auto &c : s)
+    c = 'A' + rand() % 4;
+  return s;
+}
+
+// x with about one in eight characters replaced, deleted or inserted.
+std::string mutate(const std::string &x) {
+  std::string y;
+  for (char c : x) {
+    switch (rand() % 24) {
+    case 0:
+      y.push_back('A' + rand() % 4);
+      break;
+    case 1:
+      break;
+    case 2:
+      y.push_back('A' + rand() % 4);
+      y.push_back(c);
+      break;
+    default:
+      y.push_back(c);
+      break;
+    }
+  }
+  return y;
+}
+
+// Against the full table, on strings long enough for Hirschberg to recurse.
+bool check_random() {
+  for (size_t t = 0; t < RANDOM_TESTS; ++t) {
+    const std::string x = random_string(rand() % MAX_TEST_LENGTH);
+    const std::string y =
+        rand() % 2 ? mutate(x) : random_string(rand() % MAX_TEST_LENGTH);
+    for (auto f : {edit_cost, edit_cost_noreplace}) {
+      cost_func_t costfunc = *f;
+      std::vector<transform_op_t> full, ops;
+      edit_distance_util::edit_scratch_t s;
+      edit_distance_util::align_table({x, y, costfunc, false}, 0, x.length(),
+                                      0, y.length(), s, full);
+      const size_t expected = edit_ops_cost(x, y, full, costfunc);
+      if (edit_distance_linear(x, y, costfunc) != expected ||
+          edit_distance_hirschberg(x, y, costfunc, ops) != expected)
+        return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  srand(A_BIG_PRIME_NUMBER);
+
+  std::string x = "HELLO", y = "YELLOW";
+  std::vector<transform_op_t> ops;
+
+  std::cout << "x: " << x << std::endl << "y: " << y << std::endl << std::endl;
+
+  std::cout << "Edit Distance: "
+            << edit_distance_hirschberg(x, y, edit_cost, ops) << std::endl;
+  print_edit_ops(x, y, ops);
+
+  std::cout << std::endl << "Edit without replace: " << std::endl;
+  std::cout << "Edit Distance: "
+            << edit_distance_hirschberg(x, y, edit_cost_noreplace, ops)
+            << std::endl;
+  print_edit_ops(x, y, ops);
+
+  bool ok = check_random();
+  std::cout << std::endl
+            << "Random tests against the full table: "
+            << (ok ? "match" : "MISMATCH") << std::endl;
+
+  // A long pair; the full table would need (M + 1) (N + 1) cells.
+  const size_t L = argc > 1 ? std::stoul(argv[1]) : DEFAULT_LENGTH;
+  x = random_string(L);
+  y = mutate(x);
+  std::cout << std::endl
+            << "M = " << x.length() << ", N = " << y.length()
+            << ", full table: "
+            << (x.length() + 1.0) * (y.length() + 1) * sizeof(size_t) / 1e6
+            << " MB, rows: "
+            << 2 * (std::min(x.length(), y.length()) + 1) * sizeof(size_t) /
+                   1e3
+            << " KB" << std::endl;
+
+  auto t = std::chrono::high_resolution_clock::now();
+  const size_t d = edit_distance_linear(x, y, edit_cost);
+  std::cout << "Two-row distance: " << d << " in " << elapsed_ms(t) << " ms"
+            << std::endl;
+
+  t = std::chrono::high_resolution_clock::now();
+  const size_t h = edit_distance_hirschberg(x, y, edit_cost, ops);
+  std::cout << "Hirschberg alignment: " << h << " in " << elapsed_ms(t)
+            << " ms, " << ops.size() << " operations" << std::endl;
+
+  ok = ok && d == h;
+  std::cout << (ok ? "Distances match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
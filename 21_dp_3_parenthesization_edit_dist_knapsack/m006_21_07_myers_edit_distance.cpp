@@ -0,0 +1,129 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "edit_distance.hpp"
+#include "myers_edit_distance.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Longest strings given to the DP, O(M N) cells with four costfunc calls.
+#define DP_MAX_LENGTH 4000
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+std::string random_string(size_t n) {
+  std::string s(n, 'A');
+  for (auto &c : s)
+    c = 'A' + rand() % 4;
+  return s;
+}
+
+// x with about one in eight characters replaced, deleted or inserted.
+std::string mutate(const std::string &x) {
+  std::string y;
+  for (char c : x) {
+    switch (rand() % 24) {
+    case 0:
+      y.push_back('A' + rand() % 4);
+      break;
+    case 1:
+      break;
+    case 2:
+      y.push_back('A' + rand() % 4);
+      y.push_back(c);
+      break;
+    default:
+      y.push_back(c);
+      break;
+    }
+  }
+  return y;
+}
+
+void print_cell(double v) {
+  std::cout.width(11);
+  if (v < 0)
+    std::cout << "-";
+  else
+    std::cout << v;
+}
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  std::string x = "HELLO", y = "YELLOW";
+  std::cout << "x: " << x << std::endl << "y: " << y << std::endl;
+  std::cout << "Edit Distance: " << edit_distance(x, y, edit_cost) << std::endl
+            << std::endl;
+
+  const bool avx2 = __builtin_cpu_supports("avx2");
+  bool ok = true;
+  std::cout << "Time (ms)" << std::endl;
+  std::cout << "       M        N  distance         dp       word    blocked"
+            << "       avx2" << std::endl;
+  for (size_t L : {60, 1000, 4000, 30000, 100000}) {
+    x = random_string(L);
+    y = mutate(x);
+
+    double t_dp = -1;
+    size_t d_dp = SIZE_MAX;
+    if (L <= DP_MAX_LENGTH) {
+      auto t = std::chrono::high_resolution_clock::now();
+      d_dp = edit_distance_linear(x, y, edit_cost);
+      t_dp = elapsed_ms(t);
+    }
+
+    // The single word needs the shorter string within 64 characters.
+    double t_word = -1;
+    size_t d_word = SIZE_MAX;
+    if (std::min(x.length(), y.length()) <= 64) {
+      auto t = std::chrono::high_resolution_clock::now();
+      d_word = edit_distance_myers(x, y);
+      t_word = elapsed_ms(t);
+    }
+
+    auto t = std::chrono::high_resolution_clock::now();
+    const size_t d = edit_distance_myers(x, y, 1);
+    const double t_blocked = elapsed_ms(t);
+
+    double t_avx2 = -1;
+    size_t d_avx2 = SIZE_MAX;
+    if (avx2) {
+      t = std::chrono::high_resolution_clock::now();
+      d_avx2 = edit_distance_myers(x, y, 2);
+      t_avx2 = elapsed_ms(t);
+    }
+
+    ok = ok && (d_dp == SIZE_MAX || d_dp == d) &&
+         (d_word == SIZE_MAX || d_word == d) &&
+         (d_avx2 == SIZE_MAX || d_avx2 == d);
+
+    std::cout.width(8);
+    std::cout << x.length();
+    std::cout.width(9);
+    std::cout << y.length();
+    std::cout.width(10);
+    std::cout << d;
+    print_cell(t_dp);
+    print_cell(t_word);
+    print_cell(t_blocked);
+    print_cell(t_avx2);
+    std::cout << std::endl;
+  }
+
+  std::cout << (ok ? "Distances match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bounded_edit_distance.hpp"
+#include "edit_distance.hpp"
+#include "myers_edit_distance.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Longest strings given to the full DP.
+#define DP_MAX_LENGTH 3000
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+std::string random_string(size_t n) {
+  std::string s(n, 'A');
+  for (auto &c : s)
+    c = 'A' + rand() % 4;
+  return s;
+}
+
+// x with the given number of random replacements, deletions or insertions.
+std::string edit(std::string x, size_t edits) {
+  for (size_t e = 0; e < edits; ++e) {
+    const size_t at = rand() % (x.length() + 1);
+    switch (rand() % 3) {
+    case 0:
+      if (at < x.length()) {
+        x[at] = 'A' + (x[at] - 'A' + 1 + rand() % 3) % 4;
+        break;
+      }
+      // Fall through.
+    case 1:
+      x.insert(x.begin() + at, 'A' + rand() % 4);
+      break;
+    default:
+      if (at < x.length())
+        x.erase(at, 1);
+      break;
+    }
+  }
+  return x;
+}
+
+void print_cell(double v) {
+  std::cout.width(11);
+  if (v < 0)
+    std::cout << "-";
+  else
+    std::cout << v;
+}
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  std::string x = "HELLO", y = "YELLOW";
+  std::vector<transform_op_t> ops;
+  std::cout << "x: " << x << std::endl << "y: " << y << std::endl << std::endl;
+  for (size_t k : {1, 2}) {
+    std::cout << "Within " << k << ": "
+              << (edit_distance_within(x, y, edit_cost, k) ? "yes" : "no")
+              << std::endl;
+    const size_t d = edit_distance_banded(x, y, edit_cost, k, ops);
+    if (d <= k) {
+      std::cout << "Edit Distance: " << d << std::endl;
+      print_edit_ops(x, y, ops);
+    }
+  }
+  std::cout << std::endl;
+
+  bool ok = true;
+  std::cout << "Time (ms); distances beyond k are shown as k + 1" << std::endl;
+  std::cout << "       M  edits     k  distance         dp      myers"
+            << "     banded    ukkonen" << std::endl;
+  for (size_t L : {3000, 30000}) {
+    x = random_string(L);
+    for (size_t edits : {0, 5, 50, 500}) {
+      y = edit(x, edits);
+      for (size_t k : {10, 100}) {
+        double t_dp = -1;
+        size_t d_dp = SIZE_MAX;
+        if (L <= DP_MAX_LENGTH) {
+          auto t = std::chrono::high_resolution_clock::now();
+          d_dp = std::min(edit_distance_linear(x, y, edit_cost), k + 1);
+          t_dp = elapsed_ms(t);
+        }
+
+        auto t = std::chrono::high_resolution_clock::now();
+        const size_t d_myers = std::min(edit_distance_myers(x, y), k + 1);
+        const double t_myers = elapsed_ms(t);
+
+        t = std::chrono::high_resolution_clock::now();
+        const size_t d_banded = edit_distance_banded(x, y, edit_cost, k);
+        const double t_banded = elapsed_ms(t);
+
+        t = std::chrono::high_resolution_clock::now();
+        const size_t d = edit_distance_ukkonen(x, y, k, ops);
+        const double t_ukkonen = elapsed_ms(t);
+
+        ok = ok && (d_dp == SIZE_MAX || d_dp == d) && d_myers == d &&
+             d_banded == d &&
+             (d > k || edit_ops_cost(x, y, ops, edit_cost) == d);
+
+        std::cout.width(8);
+        std::cout << L;
+        std::cout.width(7);
+        std::cout << edits;
+        std::cout.width(6);
+        std::cout << k;
+        std::cout.width(10);
+        std::cout << d;
+        print_cell(t_dp);
+        print_cell(t_myers);
+        print_cell(t_banded);
+        print_cell(t_ukkonen);
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  std::cout << (ok ? "Distances match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
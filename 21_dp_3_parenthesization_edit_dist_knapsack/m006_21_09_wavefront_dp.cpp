@@ -0,0 +1,119 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "edit_distance.hpp"
+#include "knapsack.hpp"
+#include "myers_edit_distance.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Side of the tables; 50000 for the 50K x 50K benchmark.
+#define DEFAULT_SIZE 4000
+
+#define MAX_PROFIT 100
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+std::string random_string(size_t n) {
+  std::string s(n, 'A');
+  for (auto &c : s)
+    c = 'A' + rand() % 4;
+  return s;
+}
+
+// Times run(nthreads) for 1, 2, 4 ... threads; false if a result differs
+// from expected.
+bool scaling(const std::string &name, double cells, size_t expected,
+             std::function<size_t(size_t)> run) {
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  std::cout << name << std::endl
+            << "  threads         ms   Mcells/s    speedup" << std::endl;
+  bool ok = true;
+  double base = 0;
+  for (size_t nthreads = 1; nthreads <= std::max<size_t>(hw, 4);
+       nthreads *= 2) {
+    auto t = std::chrono::high_resolution_clock::now();
+    ok = ok && run(nthreads) == expected;
+    const double ms = elapsed_ms(t);
+    if (nthreads == 1)
+      base = ms;
+    std::cout.width(9);
+    std::cout << nthreads;
+    std::cout.width(11);
+    std::cout << ms;
+    std::cout.width(11);
+    std::cout << cells / (ms * 1000);
+    std::cout.width(11);
+    std::cout << base / ms << std::endl;
+  }
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  srand(A_BIG_PRIME_NUMBER);
+  const size_t L = argc > 1 ? std::stoul(argv[1]) : DEFAULT_SIZE;
+  std::cout << "Hardware threads: " << std::thread::hardware_concurrency()
+            << std::endl
+            << std::endl;
+
+  // Edit distance of a string and a copy with about one in eight
+  // characters replaced.
+  const std::string x = random_string(L);
+  std::string y = x;
+  for (auto &c : y)
+    if (rand() % 8 == 0)
+      c = 'A' + rand() % 4;
+  const size_t d = edit_distance_myers(x, y);
+  std::cout << "Edit distance, " << L << " x " << L << ": " << d << std::endl;
+  const double cells = static_cast<double>(L) * L;
+  bool ok = scaling("Scalar rows", cells, d, [&](size_t nthreads) {
+    return edit_distance_wavefront(x, y, nthreads,
+                                   edit_distance_util::edit_row_scalar);
+  });
+  ok = scaling("Best rows", cells, d,
+               [&](size_t nthreads) {
+                 return edit_distance_wavefront(x, y, nthreads);
+               }) &&
+       ok;
+
+  // Binary knapsack of L items and capacity L.
+  std::vector<item_t> items(L);
+  for (auto &item : items) {
+    item.weight = rand_num(1, L / 8 + 2);
+    item.profit = rand_num(1, MAX_PROFIT);
+  }
+  const size_t p = knapsack_max_profit(L, items.data(), L);
+  std::cout << std::endl
+            << "Binary knapsack, " << L << " items x " << L
+            << " capacity: " << p << std::endl;
+  ok = scaling("Scalar rows", cells, p,
+               [&](size_t nthreads) {
+                 return knapsack_wavefront(
+                     L, items.data(), L, nthreads,
+                     knapsack_util::knapsack_row_scalar);
+               }) &&
+       ok;
+  ok = scaling("Best rows", cells, p,
+               [&](size_t nthreads) {
+                 return knapsack_wavefront(L, items.data(), L, nthreads);
+               }) &&
+       ok;
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bounded_edit_distance.hpp"
+#include "edit_distance.hpp"
+#include "fuzzy_search.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+#define DEFAULT_WORDS 200000 // 1000000 for the 1M word dictionary.
+#define QUERIES 64
+#define BRUTE_FORCE_QUERIES 4 // Word by word, for reference.
+#define MAX_EDITS 2
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Words of 3 to 12 letters, the early letters of the alphabet more often, so
+// that the dictionary shares prefixes the way natural words do.
+std::string random_word() {
+  std::string w(3 + rand() % 10, 'a');
+  for (auto &c : w)
+    c = 'a' + (rand() % 26) * (rand() % 26) / 26;
+  return w;
+}
+
+// w with one or two random edits.
+std::string misspell(std::string w) {
+  for (size_t e = 1 + rand() % 2; e > 0; --e) {
+    const size_t at = rand() % w.length();
+    switch (rand() % 3) {
+    case 0:
+      w[at] = 'a' + rand() % 26;
+      break;
+    case 1:
+      w.insert(w.begin() + at, 'a' + rand() % 26);
+      break;
+    default:
+      if (w.length() > 1)
+        w.erase(at, 1);
+      break;
+    }
+  }
+  return w;
+}
+
+// Every word compared with the query on its own.
+template <typename DISTANCE>
+std::vector<fuzzy_match_t> brute_force(const std::vector<std::string> &words,
+                                       const std::string &query, size_t k,
+                                       DISTANCE distance) {
+  std::vector<fuzzy_match_t> matches;
+  for (uint32_t w = 0; w < words.size(); ++w) {
+    const size_t d = distance(query, words[w]);
+    if (d <= k)
+      matches.push_back({w, static_cast<uint32_t>(d)});
+  }
+  return matches;
+}
+
+int main(int argc, char *argv[]) {
+  srand(A_BIG_PRIME_NUMBER);
+  const size_t N = argc > 1 ? std::stoul(argv[1]) : DEFAULT_WORDS;
+  const size_t k = MAX_EDITS;
+
+  std::vector<std::string> words(N);
+  for (auto &w : words)
+    w = random_word();
+  std::vector<std::string> queries(QUERIES);
+  for (auto &q : queries)
+    q = misspell(words[rand() % N]);
+
+  auto t = std::chrono::high_resolution_clock::now();
+  fuzzy_dictionary dict(words);
+  std::cout << "Dictionary: " << N << " words, " << dict.trie_nodes()
+            << " trie nodes, built in " << elapsed_ms(t) << " ms" << std::endl;
+
+  std::vector<fuzzy_match_t> matches;
+  dict.search(queries[0], k, matches, 1);
+  std::cout << "Within " << k << " of " << queries[0] << ":";
+  for (const auto &m : matches)
+    std::cout << " " << words[m.word] << " (" << m.distance << ")";
+  std::cout << std::endl << std::endl;
+
+  // Reference: word by word, with the DP and with Ukkonen's bound.
+  bool ok = true;
+  std::vector<std::vector<fuzzy_match_t>> results;
+  dict.search_batch(queries, k, results, 1);
+  double t_dp = 0, t_ukkonen = 0;
+  for (size_t q = 0; q < BRUTE_FORCE_QUERIES; ++q) {
+    t = std::chrono::high_resolution_clock::now();
+    auto by_dp = brute_force(words, queries[q], k,
+                             [](const std::string &x, const std::string &y) {
+                               return edit_distance_linear(x, y, edit_cost);
+                             });
+    t_dp += elapsed_ms(t);
+    t = std::chrono::high_resolution_clock::now();
+    auto by_ukkonen =
+        brute_force(words, queries[q], k,
+                    [k](const std::string &x, const std::string &y) {
+                      return edit_distance_ukkonen(x, y, k);
+                    });
+    t_ukkonen += elapsed_ms(t);
+    ok = ok && by_dp == results[q] && by_ukkonen == results[q];
+  }
+
+  std::cout << "ms per query, k = " << k << std::endl;
+  std::cout.width(24);
+  std::cout << "DP per word";
+  std::cout.width(12);
+  std::cout << t_dp / BRUTE_FORCE_QUERIES << std::endl;
+  std::cout.width(24);
+  std::cout << "Ukkonen per word";
+  std::cout.width(12);
+  std::cout << t_ukkonen / BRUTE_FORCE_QUERIES << std::endl;
+
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t nthreads = 1; nthreads <= std::max<size_t>(hw, 4);
+       nthreads *= 2) {
+    std::vector<std::vector<fuzzy_match_t>> batch;
+    t = std::chrono::high_resolution_clock::now();
+    dict.search_batch(queries, k, batch, nthreads);
+    const double ms = elapsed_ms(t);
+    ok = ok && batch == results;
+    std::cout.width(15);
+    std::cout << "Trie batch, ";
+    std::cout.width(2);
+    std::cout << nthreads << " threads";
+    std::cout.width(12);
+    std::cout << ms / QUERIES << std::endl;
+  }
+
+  std::cout << (ok ? "Matches agree" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "knapsack.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Largest capacity of the benchmark; 50000000 for the 50M benchmark.
+#define DEFAULT_CAPACITY 10000000
+
+#define BENCHMARK_ITEMS 100
+
+// Random instances checked against all the subsets.
+#define TEST_COUNT 2000
+#define MAX_TEST_ITEMS 12
+#define MAX_TEST_CAPACITY 60
+
+#define MIN_WEIGHT 1
+#define MAX_WEIGHT 10
+
+#define MIN_PROFIT 1
+#define MAX_PROFIT 100
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Checks every solver on small random instances against all the subsets.
+bool test_small() {
+  std::vector<item_t> items;
+  std::vector<size_t> chosen;
+  for (size_t t = 0; t < TEST_COUNT; ++t) {
+    const size_t N = rand() % (MAX_TEST_ITEMS + 1);
+    const size_t S = rand() % (MAX_TEST_CAPACITY + 1);
+    items.resize(N);
+    for (auto &item : items) {
+      item.weight = rand_num(0, MAX_TEST_CAPACITY / 3);
+      item.profit = rand_num(0, MAX_PROFIT);
+    }
+
+    size_t best = 0;
+    std::vector<bool> fits(S + 1, false);
+    for (size_t set = 0; set < (size_t(1) << N); ++set) {
+      size_t weight = 0, profit = 0;
+      for (size_t n = 0; n < N; ++n)
+        if (set >> n & 1) {
+          weight += items[n].weight;
+          profit += items[n].profit;
+        }
+      if (weight <= S) {
+        best = std::max(best, profit);
+        fits[weight] = true;
+      }
+    }
+
+    bool ok = knapsack_max_profit(S, items.data(), N) == best &&
+              knapsack_items(S, items.data(), N, chosen) == best;
+    size_t weight = 0;
+    for (size_t i = 0; i < chosen.size(); ++i) {
+      ok = ok && chosen[i] < N && (i == 0 || chosen[i - 1] < chosen[i]);
+      weight += items[chosen[i]].weight;
+    }
+    ok = ok && weight <= S;
+
+    const subset_sums sums(S, items.data(), N);
+    size_t fill = 0;
+    for (size_t c = 0; c <= S + 1; ++c) {
+      ok = ok && sums.reachable(c) == (c <= S && fits[c]);
+      if (c <= S && fits[c])
+        fill = c;
+    }
+    if (!ok || sums.max_fill() != fill)
+      return false;
+  }
+  return true;
+}
+
+void print_cell(double v) {
+  std::cout.width(11);
+  if (v < 0)
+    std::cout << "-";
+  else
+    std::cout << v;
+}
+
+int main(int argc, char *argv[]) {
+  srand(A_BIG_PRIME_NUMBER);
+  const size_t max_capacity =
+      argc > 1 ? std::stoul(argv[1]) : DEFAULT_CAPACITY;
+
+  // The instance of m006_21_03_binary_knapsack.
+  constexpr size_t N = 10;
+  item_t items[N];
+  size_t S = (N * (MAX_WEIGHT + MIN_WEIGHT)) / 4;
+  for (auto i = 0u; i < N; ++i) {
+    items[i].weight = rand_num(MIN_WEIGHT, MAX_WEIGHT);
+    items[i].profit = rand_num(MIN_PROFIT, MAX_PROFIT);
+  }
+
+  std::cout << "Knapsack Capacity: " << S << std::endl;
+  std::cout << "Index : ";
+  for (auto i = 0u; i < N; ++i)
+    std::cout << std::setw(4) << i << " ";
+  std::cout << std::endl << "Weight: ";
+  for (auto i = 0u; i < N; ++i)
+    std::cout << std::setw(4) << items[i].weight << " ";
+  std::cout << std::endl << "Profit: ";
+  for (auto i = 0u; i < N; ++i)
+    std::cout << std::setw(4) << items[i].profit << " ";
+  std::cout << std::endl << std::endl;
+
+  std::vector<size_t> chosen;
+  std::cout << "Max Profit: " << knapsack_items(S, items, N, chosen)
+            << std::endl;
+  for (auto n : chosen)
+    std::cout << "Include: " << n << std::endl;
+  const subset_sums sums(S, items, N);
+  std::cout << "Fullest Load: " << sums.max_fill() << std::endl << std::endl;
+
+  bool ok = test_small();
+  std::cout << "Small instances: " << (ok ? "match" : "MISMATCH") << std::endl
+            << std::endl;
+
+  // BENCHMARK_ITEMS items of weights up to a tenth of the capacity, so that
+  // about a fifth of them fit. Load is the fullest subset within the
+  // capacity, by the one-row DP with profits equal to weights and by the
+  // bitset.
+  std::cout << "Time (ms); row is the memory of one DP row" << std::endl
+            << "  capacity    profit   row (MB)    one-row      items"
+            << "   load dp     bitset" << std::endl;
+  std::vector<item_t> big(BENCHMARK_ITEMS), loads(BENCHMARK_ITEMS);
+  for (S = std::min<size_t>(100000, max_capacity);;
+       S = std::min(S * 10, max_capacity)) {
+    for (size_t n = 0; n < BENCHMARK_ITEMS; ++n) {
+      big[n].weight = rand_num(1, S / 10 + 2);
+      big[n].profit = rand_num(MIN_PROFIT, MAX_PROFIT);
+      loads[n] = {big[n].weight, big[n].weight};
+    }
+
+    auto t = std::chrono::high_resolution_clock::now();
+    const size_t p = knapsack_max_profit(S, big.data(), BENCHMARK_ITEMS);
+    const double t_row = elapsed_ms(t);
+
+    t = std::chrono::high_resolution_clock::now();
+    const size_t p_items =
+        knapsack_items(S, big.data(), BENCHMARK_ITEMS, chosen);
+    const double t_items = elapsed_ms(t);
+    size_t weight = 0;
+    for (auto n : chosen)
+      weight += big[n].weight;
+
+    t = std::chrono::high_resolution_clock::now();
+    const size_t fill = knapsack_max_profit(S, loads.data(), BENCHMARK_ITEMS);
+    const double t_fill = elapsed_ms(t);
+
+    t = std::chrono::high_resolution_clock::now();
+    const size_t fill_bits =
+        subset_sums(S, loads.data(), BENCHMARK_ITEMS).max_fill();
+    const double t_bits = elapsed_ms(t);
+
+    ok = ok && p_items == p && weight <= S && fill_bits == fill;
+
+    std::cout.width(10);
+    std::cout << S;
+    std::cout.width(10);
+    std::cout << p;
+    print_cell((S + 1) * sizeof(uint32_t) / 1e6);
+    print_cell(t_row);
+    print_cell(t_items);
+    print_cell(t_fill);
+    print_cell(t_bits);
+    std::cout << std::endl;
+    if (S == max_capacity)
+      break;
+  }
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "knapsack.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Most items of the benchmark; 4000 for the 4K benchmark.
+#define DEFAULT_ITEMS 2000
+
+// Weights and profits of the benchmark are in 1 ... DATA_RANGE.
+#define DATA_RANGE 1000
+
+// Nodes branch and bound may visit in the benchmark.
+#define BB_MAX_NODES 10000000
+
+// Random instances checked against all the subsets.
+#define TEST_COUNT 2000
+#define MAX_TEST_ITEMS 12
+#define MAX_TEST_CAPACITY 60
+#define MAX_TEST_PROFIT 100
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Weight and profit of the items of set, or SIZE_MAX for a repeated or
+// unknown item.
+std::pair<size_t, size_t> set_weight_profit(const std::vector<item_t> &items,
+                                            const std::vector<size_t> &set) {
+  size_t weight = 0, profit = 0;
+  for (size_t i = 0; i < set.size(); ++i) {
+    if (set[i] >= items.size() || (i && set[i - 1] >= set[i]))
+      return {SIZE_MAX, SIZE_MAX};
+    weight += items[set[i]].weight;
+    profit += items[set[i]].profit;
+  }
+  return {weight, profit};
+}
+
+// Checks every solver on small random instances against all the subsets.
+bool test_small() {
+  std::vector<item_t> items;
+  std::vector<size_t> chosen;
+  for (size_t t = 0; t < TEST_COUNT; ++t) {
+    const size_t N = rand() % (MAX_TEST_ITEMS + 1);
+    const size_t S = rand() % (MAX_TEST_CAPACITY + 1);
+    items.resize(N);
+    for (auto &item : items) {
+      item.weight = rand_num(0, MAX_TEST_CAPACITY / 3);
+      item.profit = rand_num(0, MAX_TEST_PROFIT);
+    }
+
+    size_t best = 0;
+    for (size_t set = 0; set < (size_t(1) << N); ++set) {
+      size_t weight = 0, profit = 0;
+      for (size_t n = 0; n < N; ++n)
+        if (set >> n & 1) {
+          weight += items[n].weight;
+          profit += items[n].profit;
+        }
+      if (weight <= S)
+        best = std::max(best, profit);
+    }
+
+    bool ok = knapsack_parallel(S, items.data(), N, 1 + t % 3) == best &&
+              knapsack_branch_bound(S, items.data(), N, chosen) == best;
+    auto wp = set_weight_profit(items, chosen);
+    ok = ok && wp.first <= S && wp.second == best;
+    const size_t core = knapsack_core(S, items.data(), N, chosen);
+    wp = set_weight_profit(items, chosen);
+    if (!ok || core > best || wp.first > S || wp.second != core)
+      return false;
+  }
+  return true;
+}
+
+void print_cell(double v) {
+  std::cout.width(11);
+  if (v < 0)
+    std::cout << "-";
+  else
+    std::cout << v;
+}
+
+int main(int argc, char *argv[]) {
+  srand(A_BIG_PRIME_NUMBER);
+  const size_t max_items = argc > 1 ? std::stoul(argv[1]) : DEFAULT_ITEMS;
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  std::cout << "Hardware threads: " << hw << std::endl;
+
+  bool ok = test_small();
+  std::cout << "Small instances: " << (ok ? "match" : "MISMATCH") << std::endl
+            << std::endl;
+
+  // The classic instance classes of Martello and Toth, with the capacity
+  // half the total weight. dp is the one-row DP, parallel the same on hw
+  // threads; branch and bound times out after BB_MAX_NODES nodes.
+  const std::string classes[] = {"uncorrelated", "weakly", "strongly",
+                                 "subset sum"};
+  std::cout << "Time (ms); gap is the optimum less the core heuristic's"
+            << std::endl
+            << "       class      N         S     profit         dp"
+            << "   parallel     b and b    proven       core        gap"
+            << std::endl;
+  std::vector<item_t> items;
+  std::vector<size_t> chosen;
+  for (size_t c = 0; c < 4; ++c) {
+    for (size_t N = std::min<size_t>(100, max_items);;
+         N = std::min(N * 10, max_items)) {
+      items.resize(N);
+      size_t S = 0;
+      for (auto &item : items) {
+        item.weight = rand_num(1, DATA_RANGE + 1);
+        switch (c) {
+        case 0:
+          item.profit = rand_num(1, DATA_RANGE + 1);
+          break;
+        case 1: // Within DATA_RANGE / 10 of the weight, at least 1.
+          item.profit = std::max<size_t>(item.weight +
+                                             rand_num(0, DATA_RANGE / 5 + 1),
+                                         DATA_RANGE / 10 + 1) -
+                        DATA_RANGE / 10;
+          break;
+        case 2:
+          item.profit = item.weight + DATA_RANGE / 10;
+          break;
+        default:
+          item.profit = item.weight;
+          break;
+        }
+        S += item.weight;
+      }
+      S /= 2;
+
+      auto t = std::chrono::high_resolution_clock::now();
+      const size_t p = knapsack_max_profit(S, items.data(), N);
+      const double t_dp = elapsed_ms(t);
+
+      t = std::chrono::high_resolution_clock::now();
+      const size_t p_parallel = knapsack_parallel(S, items.data(), N, hw);
+      const double t_parallel = elapsed_ms(t);
+
+      bool optimal;
+      t = std::chrono::high_resolution_clock::now();
+      const size_t p_bb = knapsack_branch_bound(S, items.data(), N, chosen,
+                                                BB_MAX_NODES, optimal);
+      const double t_bb = elapsed_ms(t);
+      auto wp = set_weight_profit(items, chosen);
+      ok = ok && p_parallel == p && wp.first <= S && wp.second == p_bb &&
+           (optimal ? p_bb == p : p_bb <= p);
+
+      t = std::chrono::high_resolution_clock::now();
+      const size_t p_core = knapsack_core(S, items.data(), N, chosen);
+      const double t_core = elapsed_ms(t);
+      wp = set_weight_profit(items, chosen);
+      ok = ok && wp.first <= S && wp.second == p_core && p_core <= p;
+
+      std::cout.width(12);
+      std::cout << classes[c];
+      std::cout.width(7);
+      std::cout << N;
+      std::cout.width(10);
+      std::cout << S;
+      std::cout.width(11);
+      std::cout << p;
+      print_cell(t_dp);
+      print_cell(t_parallel);
+      print_cell(t_bb);
+      std::cout.width(10);
+      std::cout << (optimal ? "yes" : "no");
+      print_cell(t_core);
+      print_cell(p - p_core);
+      std::cout << std::endl;
+      if (N == max_items)
+        break;
+    }
+  }
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "knapsack.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Capacity of the benchmark's one-dimensional knapsacks, and weight and
+// volume capacity of the two-dimensional ones.
+#define DEFAULT_CAPACITY 1000000
+#define DEFAULT_CAPACITY_2D 2000
+
+#define BENCHMARK_ITEMS 200
+#define MAX_PROFIT 1000
+
+// Random instances checked against plain DPs; every other one has profits
+// too large for 32 bits.
+#define TEST_COUNT 2000
+#define MAX_TEST_ITEMS 10
+#define MAX_TEST_CAPACITY 40
+#define WIDE_PROFIT_SCALE 100000000
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Unbounded knapsack by capacity: the best of each capacity is the best of
+// some item added to the best of the capacity left.
+size_t unbounded_reference(size_t S, const std::vector<item_t> &items) {
+  std::vector<size_t> best(S + 1, 0);
+  for (size_t w = 1; w <= S; ++w)
+    for (const auto &item : items)
+      if (item.weight <= w)
+        best[w] = std::max(best[w], best[w - item.weight] + item.profit);
+  return best[S];
+}
+
+// The same with weights and volumes.
+size_t unbounded_reference_2d(size_t S, size_t V,
+                              const std::vector<item2_t> &items) {
+  std::vector<size_t> best((S + 1) * (V + 1), 0);
+  for (size_t w = 0; w <= S; ++w)
+    for (size_t v = 0; v <= V; ++v)
+      for (const auto &item : items)
+        if (item.weight <= w && item.volume <= v)
+          best[w * (V + 1) + v] = std::max(
+              best[w * (V + 1) + v],
+              best[(w - item.weight) * (V + 1) + v - item.volume] +
+                  item.profit);
+  return best[S * (V + 1) + V];
+}
+
+// Binary knapsack with weights and volumes over all the subsets.
+size_t subsets_2d(size_t S, size_t V, const std::vector<item2_t> &items) {
+  size_t best = 0;
+  for (size_t set = 0; set < (size_t(1) << items.size()); ++set) {
+    size_t weight = 0, volume = 0, profit = 0;
+    for (size_t n = 0; n < items.size(); ++n)
+      if (set >> n & 1) {
+        weight += items[n].weight;
+        volume += items[n].volume;
+        profit += items[n].profit;
+      }
+    if (weight <= S && volume <= V)
+      best = std::max(best, profit);
+  }
+  return best;
+}
+
+// Checks every variant, with both kernels, on small random instances.
+bool test_small() {
+  const knapsack_relax_kernel_t kernels[] = {
+      knapsack_util::relax_scalar<uint32_t>, select_knapsack_relax_kernel()};
+  std::vector<item_t> items;
+  std::vector<item2_t> items2, positive;
+  for (size_t t = 0; t < TEST_COUNT; ++t) {
+    const size_t N = rand() % (MAX_TEST_ITEMS + 1);
+    const size_t S = rand() % (MAX_TEST_CAPACITY + 1);
+    const size_t V = rand() % (MAX_TEST_CAPACITY + 1);
+    const size_t scale = t % 2 ? 1 : WIDE_PROFIT_SCALE;
+    items.resize(N);
+    items2.resize(N);
+    for (size_t n = 0; n < N; ++n) {
+      items[n].weight = rand_num(1, MAX_TEST_CAPACITY / 2);
+      items[n].profit = rand_num(0, MAX_PROFIT) * scale;
+      items2[n].weight = rand_num(0, MAX_TEST_CAPACITY / 3);
+      items2[n].volume = rand_num(0, MAX_TEST_CAPACITY / 3);
+      items2[n].profit = rand_num(0, MAX_PROFIT) * scale;
+    }
+    // The unbounded knapsack needs positive weights.
+    positive = items2;
+    for (auto &item : positive)
+      item.weight = std::max<size_t>(item.weight, 1);
+
+    const size_t unbounded = unbounded_reference(S, items);
+    const size_t binary_2d = subsets_2d(S, V, items2);
+    const size_t unbounded_2d = unbounded_reference_2d(S, V, positive);
+    for (auto kernel : kernels)
+      if (knapsack_unbounded(S, items.data(), N, kernel) != unbounded ||
+          knapsack_2d(S, V, items2.data(), N, kernel) != binary_2d ||
+          knapsack_2d_unbounded(S, V, positive.data(), N, kernel) !=
+              unbounded_2d)
+        return false;
+  }
+  return true;
+}
+
+void print_cell(double v) {
+  std::cout.width(11);
+  if (v < 0)
+    std::cout << "-";
+  else
+    std::cout << v;
+}
+
+// Times scalar and best, which must agree, and prints a row.
+bool compare(const std::string &variant, std::function<size_t()> scalar,
+             std::function<size_t()> best) {
+  auto t = std::chrono::high_resolution_clock::now();
+  const size_t p_scalar = scalar();
+  const double t_scalar = elapsed_ms(t);
+  t = std::chrono::high_resolution_clock::now();
+  const size_t p = best();
+  const double t_best = elapsed_ms(t);
+
+  std::cout.width(20);
+  std::cout << variant;
+  std::cout.width(11);
+  std::cout << p;
+  print_cell(t_scalar);
+  print_cell(t_best);
+  print_cell(t_scalar / t_best);
+  std::cout << std::endl;
+  return p == p_scalar;
+}
+
+int main(int argc, char *argv[]) {
+  srand(A_BIG_PRIME_NUMBER);
+  const size_t S = argc > 1 ? std::stoul(argv[1]) : DEFAULT_CAPACITY;
+  const size_t S2 = argc > 2 ? std::stoul(argv[2]) : DEFAULT_CAPACITY_2D;
+
+  bool ok = test_small();
+  std::cout << "Small instances: " << (ok ? "match" : "MISMATCH") << std::endl
+            << std::endl;
+
+  // BENCHMARK_ITEMS items of weights and volumes up to a tenth of the
+  // capacities, with profits unrelated to them or their weight plus a
+  // tenth of MAX_PROFIT.
+  const knapsack_relax_kernel_t scalar = knapsack_util::relax_scalar<uint32_t>;
+  std::vector<item_t> items(BENCHMARK_ITEMS);
+  std::vector<item2_t> items2(BENCHMARK_ITEMS);
+  for (bool correlated : {false, true}) {
+    for (size_t n = 0; n < BENCHMARK_ITEMS; ++n) {
+      items[n].weight = rand_num(1, S / 10 + 2);
+      items2[n].weight = rand_num(1, S2 / 10 + 2);
+      items2[n].volume = rand_num(1, S2 / 10 + 2);
+      if (correlated) {
+        items[n].profit = items[n].weight + MAX_PROFIT / 10;
+        items2[n].profit = items2[n].weight + MAX_PROFIT / 10;
+      } else {
+        items[n].profit = rand_num(1, MAX_PROFIT);
+        items2[n].profit = rand_num(1, MAX_PROFIT);
+      }
+    }
+
+    std::cout << BENCHMARK_ITEMS
+              << (correlated ? " correlated" : " uncorrelated")
+              << " items; capacity " << S << ", " << S2 << " x " << S2
+              << " in 2-D" << std::endl
+              << "Time (ms)" << std::endl
+              << "             variant     profit     scalar       best"
+              << "    speedup" << std::endl;
+    const item_t *p1 = items.data();
+    const item2_t *p2 = items2.data();
+    const size_t N = BENCHMARK_ITEMS;
+    ok = compare(
+             "binary",
+             [&] {
+               return knapsack_parallel(S, p1, N, 1,
+                                        knapsack_util::knapsack_row_scalar);
+             },
+             [&] { return knapsack_parallel(S, p1, N, 1); }) &&
+         ok;
+    ok = compare(
+             "unbounded",
+             [&] { return knapsack_unbounded(S, p1, N, scalar); },
+             [&] { return knapsack_unbounded(S, p1, N); }) &&
+         ok;
+    ok = compare(
+             "binary 2-D",
+             [&] { return knapsack_2d(S2, S2, p2, N, scalar); },
+             [&] { return knapsack_2d(S2, S2, p2, N); }) &&
+         ok;
+    ok = compare(
+             "unbounded 2-D",
+             [&] { return knapsack_2d_unbounded(S2, S2, p2, N, scalar); },
+             [&] { return knapsack_2d_unbounded(S2, S2, p2, N); }) &&
+         ok;
+    std::cout << std::endl;
+  }
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define NIL UINT32_MAX
+
+// Cost of multiplying 2 matrices of dimensions d1 X d2 and d2 X d3.
+inline size_t mult_cost(size_t d1, size_t d2, size_t d3) {
+  // In brute force matrix multiplication, calculation of each element of the
+  // product requires d2 multiplications and the product is of d1 X d3
+  // dimension.
+  return (d1 * d2 * d3);
+}
+
+// Multiplication order of a chain of N matrices A_0 ... A_N-1, as a binary
+// tree. Nodes 0 ... N-1 are the matrices themselves; every other node
+// multiplies the products of its two children and covers A_lo ... A_hi.
+struct chain_order_t {
+  struct node_t {
+    uint32_t left;
+    uint32_t right;
+    uint32_t lo;
+    uint32_t hi;
+  };
+
+  std::vector<node_t> nodes;
+  uint32_t root;
+};
+
+// Total mult_cost of multiplying in the given order.
+inline size_t chain_cost(const chain_order_t &order, const size_t *dimension) {
+  size_t cost = 0;
+  for (const auto &n : order.nodes)
+    if (n.left != NIL)
+      cost += mult_cost(dimension[n.lo], dimension[order.nodes[n.right].lo],
+                        dimension[n.hi + 1]);
+  return cost;
+}
+
+// Parenthesized string of the order, e.g. ((A0 A1) A2), built without
+// recursion into a single string.
+inline std::string parenthesize(const chain_order_t &order) {
+  std::string s;
+  if (order.nodes.empty())
+    return s;
+
+  // Either a node to expand or a literal character to append.
+  struct item_t {
+    uint32_t node;
+    char literal;
+  };
+  std::vector<item_t> stack = {{order.root, 0}};
+  while (!stack.empty()) {
+    item_t it = stack.back();
+    stack.pop_back();
+    if (it.node == NIL) {
+      s.push_back(it.literal);
+      continue;
+    }
+    const auto &n = order.nodes[it.node];
+    if (n.left == NIL) {
+      s += "A";
+      s += std::to_string(it.node);
+      continue;
+    }
+    // Pushed in reverse.
+    stack.push_back({NIL, ')'});
+    stack.push_back({n.right, 0});
+    stack.push_back({NIL, ' '});
+    stack.push_back({n.left, 0});
+    stack.push_back({NIL, '('});
+  }
+  return s;
+}
+
+// Order of N matrices from pivots, built without recursion: pivot(i, j) = k
+// multiplies A_i ... A_k-1 by A_k ... A_j.
+template <typename PIVOT>
+chain_order_t chain_order_from_pivots(size_t N, PIVOT pivot) {
+  chain_order_t o;
+  o.nodes.reserve(2 * N);
+  for (uint32_t i = 0; i < N; ++i)
+    o.nodes.push_back({NIL, NIL, i, i});
+
+  std::vector<uint32_t> stack;
+  auto make = [&](uint32_t lo, uint32_t hi) {
+    if (lo == hi)
+      return lo;
+    o.nodes.push_back({NIL, NIL, lo, hi});
+    stack.push_back(static_cast<uint32_t>(o.nodes.size() - 1));
+    return stack.back();
+  };
+
+  o.root = N ? make(0, static_cast<uint32_t>(N - 1)) : NIL;
+  while (!stack.empty()) {
+    uint32_t id = stack.back();
+    stack.pop_back();
+    const uint32_t lo = o.nodes[id].lo, hi = o.nodes[id].hi;
+    const uint32_t k = pivot(lo, hi);
+    const uint32_t l = make(lo, k - 1);
+    const uint32_t r = make(k, hi);
+    o.nodes[id].left = l;
+    o.nodes[id].right = r;
+  }
+  return o;
+}
+
+// Upper triangle (i <= j) of an N x N table, on the heap.
+// Costs are stored twice, row-major and column-major, so the DP's scan of
+// least_cost[i][k - 1] and least_cost[k][j] over k reads both sequentially.
+// Pivots are only written by the DP, diagonal by diagonal, and are stored
+// diagonal-major so the writes are sequential.
+class chain_table {
+private:
+  const size_t N;
+  std::vector<size_t> rows; // Row i holds j = i ... N - 1.
+  std::vector<size_t> cols; // Column j holds i = 0 ... j.
+  std::vector<uint32_t> pivots;
+
+  size_t row_offset(size_t i) const { return i * N - i * (i - 1) / 2; }
+  size_t col_offset(size_t j) const { return j * (j + 1) / 2; }
+  size_t diag_offset(size_t d) const { return d * N - d * (d - 1) / 2; }
+
+public:
+  explicit chain_table(size_t _N)
+      : N(_N), rows(N * (N + 1) / 2), cols(N * (N + 1) / 2),
+        pivots(N * (N + 1) / 2) {}
+
+  // least_cost[i][i ...] and least_cost[... j][j].
+  const size_t *row(size_t i) const { return &rows[row_offset(i)] - i; }
+  const size_t *col(size_t j) const { return &cols[col_offset(j)]; }
+
+  size_t cost(size_t i, size_t j) const { return row(i)[j]; }
+
+  void set_cost(size_t i, size_t j, size_t c) {
+    rows[row_offset(i) + j - i] = c;
+    cols[col_offset(j) + i] = c;
+  }
+
+  uint32_t pivot(size_t i, size_t j) const {
+    return pivots[diag_offset(j - i) + i];
+  }
+
+  void set_pivot(size_t i, size_t j, uint32_t k) {
+    pivots[diag_offset(j - i) + i] = k;
+  }
+
+  // Order following the pivots.
+  chain_order_t order() const;
+};
+
+inline chain_order_t chain_table::order() const {
+  return chain_order_from_pivots(
+      N, [this](uint32_t i, uint32_t j) { return pivot(i, j); });
+}
+
+// The DP of dp_matrix_chain_mult_order on a chain_table: O(N^3) time,
+// O(N^2) heap space.
+inline size_t matrix_chain_dp(const size_t *dimension, size_t N,
+                              chain_table &t) {
+  if (N == 0)
+    return 0;
+
+  // Seed values, no cost for multiplying a single matrix.
+  for (size_t i = 0; i < N; ++i)
+    t.set_cost(i, i, 0);
+
+  for (size_t d = 1; d < N; ++d) {
+    for (size_t i = 0; i < N - d; ++i) {
+      const size_t j = i + d;
+      const size_t *ri = t.row(i), *cj = t.col(j);
+      const size_t di = dimension[i], dj = dimension[j + 1];
+      size_t best = SIZE_MAX, best_k = j;
+      for (size_t k = i + 1; k <= j; ++k) {
+        auto cost = ri[k - 1] + cj[k] + mult_cost(di, dimension[k], dj);
+        if (cost < best) {
+          best = cost;
+          best_k = k;
+        }
+      }
+      t.set_cost(i, j, best);
+      t.set_pivot(i, j, static_cast<uint32_t>(best_k));
+    }
+  }
+
+  return t.cost(0, N - 1);
+}
+
+// Near-optimal order in O(N) time and space, for chains too long for a
+// quadratic table (Chin; Hu and Shing bound its cost within 15.5% of the
+// optimum).
+// The chain is the polygon with vertex weights dimension[0 ... N], each
+// matrix an edge, and an order is a triangulation: multiplying at inner
+// dimension c, between neighbours a and b, cuts off the triangle (a, c, b).
+// With w the smallest weight, cutting c before joining it to w is the
+// cheaper way to split the quadrilateral (w, a, c, b) iff
+//   1 / w + 1 / d[c] < 1 / d[a] + 1 / d[b].
+// Walking the polygon from w with a stack, c is cut as soon as that holds
+// for its current neighbours; the vertices left over are joined to w.
+inline chain_order_t matrix_chain_chin(const size_t *dimension, size_t N) {
+  if (N < 2)
+    return chain_order_from_pivots(N, [](uint32_t, uint32_t) { return 0u; });
+
+  // apex[x * (N + 1) + z] would need N^2 space; a triangle (x, y, z) with x
+  // < y < z is found from its widest side instead: apex of (x, z) is y.
+  const size_t V = N + 1;
+  std::vector<std::pair<uint64_t, uint32_t>> apex;
+  apex.reserve(N);
+  auto add_triangle = [&](size_t a, size_t b, size_t c) {
+    size_t lo = std::min({a, b, c}), hi = std::max({a, b, c});
+    apex.emplace_back(lo * V + hi, static_cast<uint32_t>(a + b + c - lo - hi));
+  };
+
+  const size_t m =
+      std::min_element(dimension, dimension + V) - dimension; // Smallest.
+  const double inv_w = 1.0 / dimension[m];
+  auto inv = [dimension](size_t v) { return 1.0 / dimension[v]; };
+
+  std::vector<size_t> stack = {m, (m + 1) % V};
+  for (size_t step = 2; step <= V; ++step) {
+    const size_t b = (m + step) % V; // Back at m on the last step.
+    while (stack.size() >= 3) {
+      const size_t c = stack.back(), a = stack[stack.size() - 2];
+      if (!(inv_w + inv(c) < inv(a) + inv(b)))
+        break;
+      add_triangle(a, c, b);
+      stack.pop_back();
+    }
+    if (b != m)
+      stack.push_back(b);
+  }
+  // Fan from m over what is left.
+  for (size_t i = 1; i + 1 < stack.size(); ++i)
+    add_triangle(m, stack[i], stack[i + 1]);
+
+  std::sort(apex.begin(), apex.end());
+  // Matrices A_i ... A_j span the vertices i ... j + 1.
+  return chain_order_from_pivots(N, [&](uint32_t i, uint32_t j) {
+    auto it = std::lower_bound(apex.begin(), apex.end(),
+                               std::make_pair(i * V + j + 1, uint32_t(0)));
+    return it->second;
+  });
+}
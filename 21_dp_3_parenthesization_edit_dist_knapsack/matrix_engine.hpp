@@ -0,0 +1,286 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "matrix_chain.hpp"
+
+// Blocking of the GEMM kernels: a GEMM_KC x GEMM_NC panel of B (256 KB of
+// doubles) stays in L2 while every row of A runs over it.
+#define GEMM_KC 128
+#define GEMM_NC 256
+
+// Dense row-major matrix.
+struct matrix_t {
+  size_t rows = 0;
+  size_t cols = 0;
+  std::vector<double> data;
+
+  matrix_t() = default;
+  matrix_t(size_t _rows, size_t _cols)
+      : rows(_rows), cols(_cols), data(_rows * _cols) {}
+
+  double *row(size_t i) { return &data[i * cols]; }
+  const double *row(size_t i) const { return &data[i * cols]; }
+};
+
+// C[m x p] += A[m x n] * B[n x p] for rows [i_lo, i_hi) of A and C, all
+// row-major.
+typedef void (*gemm_kernel_t)(const double *A, const double *B, double *C,
+                              size_t i_lo, size_t i_hi, size_t n, size_t p);
+
+namespace matrix_engine_util {
+// Scalar i-k-j loops over the same blocks as the AVX2 kernel.
+inline void gemm_scalar(const double *A, const double *B, double *C,
+                        size_t i_lo, size_t i_hi, size_t n, size_t p) {
+  for (size_t jb = 0; jb < p; jb += GEMM_NC) {
+    const size_t j_hi = std::min(p, jb + GEMM_NC);
+    for (size_t kb = 0; kb < n; kb += GEMM_KC) {
+      const size_t k_hi = std::min(n, kb + GEMM_KC);
+      for (size_t i = i_lo; i < i_hi; ++i) {
+        double *c = C + i * p;
+        for (size_t k = kb; k < k_hi; ++k) {
+          const double a = A[i * n + k];
+          const double *b = B + k * p;
+          for (size_t j = jb; j < j_hi; ++j)
+            c[j] += a * b[j];
+        }
+      }
+    }
+  }
+}
+
+// 4 x 8 block of C kept in 8 registers while k runs over the panel.
+__attribute__((target("avx2,fma"))) inline void
+gemm_block_4x8_avx2(const double *A, const double *B, double *C, size_t i,
+                    size_t j, size_t kb, size_t k_hi, size_t n, size_t p) {
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  const double *a = A + i * n;
+  for (size_t k = kb; k < k_hi; ++k) {
+    const __m256d b0 = _mm256_loadu_pd(B + k * p + j);
+    const __m256d b1 = _mm256_loadu_pd(B + k * p + j + 4);
+    __m256d x = _mm256_broadcast_sd(a + k);
+    c00 = _mm256_fmadd_pd(x, b0, c00);
+    c01 = _mm256_fmadd_pd(x, b1, c01);
+    x = _mm256_broadcast_sd(a + n + k);
+    c10 = _mm256_fmadd_pd(x, b0, c10);
+    c11 = _mm256_fmadd_pd(x, b1, c11);
+    x = _mm256_broadcast_sd(a + 2 * n + k);
+    c20 = _mm256_fmadd_pd(x, b0, c20);
+    c21 = _mm256_fmadd_pd(x, b1, c21);
+    x = _mm256_broadcast_sd(a + 3 * n + k);
+    c30 = _mm256_fmadd_pd(x, b0, c30);
+    c31 = _mm256_fmadd_pd(x, b1, c31);
+  }
+  double *c = C + i * p + j;
+  _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c00));
+  _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c01));
+  c += p;
+  _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c10));
+  _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c11));
+  c += p;
+  _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c20));
+  _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c21));
+  c += p;
+  _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c30));
+  _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c31));
+}
+
+// Full 4 x 8 blocks with AVX2 and FMA; the ragged right and bottom edges of
+// each panel go through the scalar loop.
+__attribute__((target("avx2,fma"))) inline void
+gemm_avx2(const double *A, const double *B, double *C, size_t i_lo,
+          size_t i_hi, size_t n, size_t p) {
+  for (size_t jb = 0; jb < p; jb += GEMM_NC) {
+    const size_t j_hi = std::min(p, jb + GEMM_NC);
+    const size_t j_full = jb + (j_hi - jb) / 8 * 8;
+    for (size_t kb = 0; kb < n; kb += GEMM_KC) {
+      const size_t k_hi = std::min(n, kb + GEMM_KC);
+      size_t i = i_lo;
+      for (; i + 4 <= i_hi; i += 4)
+        for (size_t j = jb; j < j_full; j += 8)
+          gemm_block_4x8_avx2(A, B, C, i, j, kb, k_hi, n, p);
+      for (size_t r = i_lo; r < i_hi; ++r) {
+        // Rows past the last full block take every column, the others only
+        // the columns right of j_full.
+        const size_t j_lo = r < i ? j_full : jb;
+        double *c = C + r * p;
+        for (size_t k = kb; k < k_hi; ++k) {
+          const double a = A[r * n + k];
+          const double *b = B + k * p;
+          for (size_t j = j_lo; j < j_hi; ++j)
+            c[j] += a * b[j];
+        }
+      }
+    }
+  }
+}
+} // namespace matrix_engine_util
+
+// The fastest kernel the CPU supports.
+inline gemm_kernel_t select_gemm_kernel() {
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return matrix_engine_util::gemm_avx2;
+  return matrix_engine_util::gemm_scalar;
+}
+
+// C = A * B, the rows of C split among nthreads threads.
+inline void gemm(const matrix_t &A, const matrix_t &B, matrix_t &C,
+                 size_t nthreads, gemm_kernel_t kernel) {
+  std::fill(C.data.begin(), C.data.end(), 0.0);
+  // Whole blocks of 4 rows per thread.
+  const size_t chunk = (A.rows / std::max<size_t>(nthreads, 1) + 3) / 4 * 4;
+  std::vector<std::thread> workers;
+  size_t i = 0;
+  for (; chunk && i + chunk < A.rows; i += chunk)
+    workers.emplace_back(kernel, A.data.data(), B.data.data(), C.data.data(),
+                         i, i + chunk, A.cols, B.cols);
+  kernel(A.data.data(), B.data.data(), C.data.data(), i, A.rows, A.cols,
+         B.cols);
+  for (auto &w : workers)
+    w.join();
+}
+
+// Multiplies a chain of matrices in a given order.
+// Independent subtrees of the order are multiplied in parallel: a product
+// is ready once both its factors are, and idle threads take the ready
+// product with the highest mult_cost. Once fewer products are ready than
+// there are threads, the spare threads split the rows of a product.
+// Intermediate buffers are returned to a pool as soon as their product has
+// been consumed and are reused, across calls too.
+class chain_multiplier {
+private:
+  const size_t nthreads;
+  const gemm_kernel_t kernel;
+  std::vector<std::vector<double>> pool;
+
+  std::vector<double> acquire(size_t size) {
+    // Smallest pooled buffer that fits, else the largest, grown.
+    size_t best = pool.size();
+    for (size_t b = 0; b < pool.size(); ++b)
+      if (pool[b].capacity() >= size &&
+          (best == pool.size() || pool[b].capacity() < pool[best].capacity()))
+        best = b;
+    if (best == pool.size())
+      for (size_t b = 0; b < pool.size(); ++b)
+        if (best == pool.size() || pool[b].capacity() > pool[best].capacity())
+          best = b;
+    if (best == pool.size())
+      return std::vector<double>(size);
+    std::swap(pool[best], pool.back());
+    std::vector<double> buf = std::move(pool.back());
+    pool.pop_back();
+    buf.resize(size);
+    return buf;
+  }
+
+public:
+  explicit chain_multiplier(size_t _nthreads,
+                            gemm_kernel_t _kernel = select_gemm_kernel())
+      : nthreads(std::max<size_t>(_nthreads, 1)), kernel(_kernel) {}
+
+  matrix_t multiply(const std::vector<matrix_t> &chain,
+                    const chain_order_t &order);
+
+  // Buffers held for reuse.
+  size_t pooled() const { return pool.size(); }
+};
+
+inline matrix_t chain_multiplier::multiply(const std::vector<matrix_t> &chain,
+                                           const chain_order_t &order) {
+  const size_t N = chain.size();
+  if (N == 0)
+    return matrix_t();
+  if (N == 1)
+    return chain[0];
+
+  const auto &nodes = order.nodes;
+  std::vector<matrix_t> products(nodes.size());
+  std::vector<uint32_t> parent(nodes.size(), NIL);
+  std::vector<uint8_t> pending(nodes.size(), 0);
+  std::vector<uint32_t> ready;
+  for (uint32_t id = N; id < nodes.size(); ++id) {
+    parent[nodes[id].left] = parent[nodes[id].right] = id;
+    pending[id] = (nodes[id].left >= N) + (nodes[id].right >= N);
+    if (!pending[id])
+      ready.push_back(id);
+  }
+  auto operand = [&](uint32_t id) -> const matrix_t & {
+    return id < N ? chain[id] : products[id];
+  };
+  auto cost = [&](uint32_t id) {
+    return mult_cost(operand(nodes[id].left).rows,
+                     operand(nodes[id].left).cols,
+                     operand(nodes[id].right).cols);
+  };
+
+  std::mutex m;
+  std::condition_variable cv;
+  size_t remaining = nodes.size() - N, busy = 0;
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(m);
+    while (true) {
+      cv.wait(lock, [&] { return !ready.empty() || !remaining; });
+      if (!remaining)
+        return;
+      auto it = std::max_element(
+          ready.begin(), ready.end(),
+          [&](uint32_t a, uint32_t b) { return cost(a) < cost(b); });
+      const uint32_t id = *it;
+      *it = ready.back();
+      ready.pop_back();
+      ++busy;
+      // Threads neither busy nor needed for another ready product.
+      const size_t spare =
+          nthreads > busy + ready.size() ? nthreads - busy - ready.size() : 0;
+      const matrix_t &A = operand(nodes[id].left);
+      const matrix_t &B = operand(nodes[id].right);
+      matrix_t C;
+      C.rows = A.rows;
+      C.cols = B.cols;
+      C.data = acquire(C.rows * C.cols);
+      lock.unlock();
+
+      gemm(A, B, C, 1 + spare, kernel);
+
+      lock.lock();
+      products[id] = std::move(C);
+      for (uint32_t f : {nodes[id].left, nodes[id].right})
+        if (f >= N) {
+          pool.push_back(std::move(products[f].data));
+          products[f].data = std::vector<double>();
+        }
+      --busy;
+      --remaining;
+      const uint32_t up = parent[id];
+      if (up != NIL && !--pending[up])
+        ready.push_back(up);
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < nthreads; ++t)
+    workers.emplace_back(worker);
+  worker();
+  for (auto &w : workers)
+    w.join();
+  return std::move(products[order.root]);
+}
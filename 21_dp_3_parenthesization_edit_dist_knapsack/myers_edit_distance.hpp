@@ -0,0 +1,205 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <immintrin.h>
+
+#include "edit_distance.hpp"
+
+// Myers' bit-vector algorithm for the unit cost (Levenshtein) distance, in
+// the block form of Hyyro: the shorter string p, of m characters, is split
+// in blocks of 64 rows and each column of the DP on p and the longer string
+// t is a pair of bit vectors per block,
+//   Pv bit r set: D[r + 1][j] - D[r][j] = +1,
+//   Mv bit r set: D[r + 1][j] - D[r][j] = -1.
+// A block turns its column j - 1 into column j given the horizontal delta
+// hin = D[top][j] - D[top][j - 1] entering at its top row, and passes on
+// the delta at its bottom row. As D[0][j] = j every column enters the first
+// block with +1, and D[m][n] = n + (the vertical deltas of column n).
+// Rows past m in the last block only feed rows below them and are ignored.
+
+namespace myers_util {
+// Match masks, Peq[c * W + b] bit r set iff p[64 b + r] == c; W is rounded
+// up to a multiple of 4 blocks for the AVX2 variant.
+struct pattern_t {
+  size_t m;
+  size_t W;
+  std::vector<uint64_t> peq;
+
+  explicit pattern_t(const std::string &p)
+      : m(p.length()), W((p.length() + 255) / 256 * 4), peq(256 * W, 0) {
+    for (size_t i = 0; i < m; ++i)
+      peq[static_cast<unsigned char>(p[i]) * W + i / 64] |= uint64_t(1)
+                                                            << (i % 64);
+  }
+
+  const uint64_t *eq(char c) const {
+    return &peq[static_cast<unsigned char>(c) * W];
+  }
+};
+
+// One block, one column; returns the horizontal delta at the bottom row.
+inline int advance_block(uint64_t &Pv, uint64_t &Mv, uint64_t Eq, int hin) {
+  const uint64_t hin_neg = hin < 0, hin_pos = hin > 0;
+  const uint64_t Xv = Eq | Mv;
+  Eq |= hin_neg;
+  const uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+  uint64_t Ph = Mv | ~(Xh | Pv);
+  uint64_t Mh = Pv & Xh;
+  const int hout = static_cast<int>(Ph >> 63) - static_cast<int>(Mh >> 63);
+  Ph = (Ph << 1) | hin_pos;
+  Mh = (Mh << 1) | hin_neg;
+  Pv = Mh | ~(Xv | Ph);
+  Mv = Ph & Xv;
+  return hout;
+}
+
+// D[m][n] from the vertical deltas of the last column.
+inline size_t last_row(const std::vector<uint64_t> &Pv,
+                       const std::vector<uint64_t> &Mv, size_t m, size_t n) {
+  ssize_t d = n;
+  for (size_t b = 0; b * 64 < m; ++b) {
+    const uint64_t rows =
+        m - b * 64 >= 64 ? ~uint64_t(0) : (uint64_t(1) << (m - b * 64)) - 1;
+    d += __builtin_popcountll(Pv[b] & rows) -
+         __builtin_popcountll(Mv[b] & rows);
+  }
+  return d;
+}
+
+// Column by column, every block top to bottom.
+inline size_t distance_blocked(const pattern_t &p, const std::string &t) {
+  const size_t B = (p.m + 63) / 64;
+  std::vector<uint64_t> Pv(B, ~uint64_t(0)), Mv(B, 0);
+  for (char c : t) {
+    const uint64_t *eq = p.eq(c);
+    int h = 1;
+    for (size_t b = 0; b < B; ++b)
+      h = advance_block(Pv[b], Mv[b], eq[b], h);
+  }
+  return last_row(Pv, Mv, p.m, t.length());
+}
+
+// A single block, kept in registers.
+inline size_t distance_word(const pattern_t &p, const std::string &t) {
+  uint64_t Pv = ~uint64_t(0), Mv = 0;
+  for (char c : t)
+    advance_block(Pv, Mv, p.eq(c)[0], 1);
+  std::vector<uint64_t> pv = {Pv}, mv = {Mv};
+  return last_row(pv, mv, p.m, t.length());
+}
+
+// Strips of 4 blocks, one per 64-bit lane. Block b of column j depends only
+// on block b - 1 of column j and block b of column j - 1, so the lanes run
+// skewed: at step s, lane k advances block b0 + k to column s - k, taking
+// hin from lane k - 1 of the previous step. Lane 0 takes the bottom deltas
+// left by the strip above in carry, lane 3 leaves its own there.
+__attribute__((target("avx2"))) inline size_t
+distance_avx2(const pattern_t &p, const std::string &t) {
+  const size_t n = t.length();
+  const size_t strips = p.W / 4;
+  std::vector<uint64_t> Pv(p.W, ~uint64_t(0)), Mv(p.W, 0);
+  std::vector<int64_t> carry(n, 1);
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+
+  for (size_t s0 = 0; s0 < strips; ++s0) {
+    const size_t b0 = s0 * 4;
+    __m256i P = _mm256_loadu_si256(reinterpret_cast<__m256i *>(&Pv[b0]));
+    __m256i M = _mm256_loadu_si256(reinterpret_cast<__m256i *>(&Mv[b0]));
+    __m256i hin = _mm256_setzero_si256();
+    __m256i chars = _mm256_setzero_si256();
+    for (size_t s = 0; s < n + 3; ++s) {
+      // Lane k at column s - k; active while 0 <= s - k < n.
+      const __m256i col = _mm256_sub_epi64(
+          _mm256_set1_epi64x(static_cast<int64_t>(s)), lane);
+      const __m256i active = _mm256_andnot_si256(
+          _mm256_cmpgt_epi64(_mm256_setzero_si256(), col),
+          _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<int64_t>(n)),
+                             col));
+      if (s < n)
+        hin = _mm256_insert_epi64(hin, carry[s], 0);
+
+      // Eq of block b0 + k for character t[s - k]; the characters move down
+      // the lanes like hin.
+      chars = _mm256_insert_epi64(
+          chars, s < n ? static_cast<unsigned char>(t[s]) : 0, 0);
+      const __m256i offsets = _mm256_add_epi64(
+          _mm256_mul_epu32(chars, _mm256_set1_epi64x(p.W)),
+          _mm256_add_epi64(_mm256_set1_epi64x(b0), lane));
+      __m256i Eq = _mm256_i64gather_epi64(
+          reinterpret_cast<const long long *>(p.peq.data()), offsets, 8);
+
+      const __m256i hin_neg = _mm256_srli_epi64(hin, 63);
+      const __m256i hin_pos = _mm256_and_si256(_mm256_cmpeq_epi64(hin, one),
+                                               one);
+      const __m256i Xv = _mm256_or_si256(Eq, M);
+      Eq = _mm256_or_si256(Eq, hin_neg);
+      const __m256i Xh = _mm256_or_si256(
+          _mm256_xor_si256(
+              _mm256_add_epi64(_mm256_and_si256(Eq, P), P), P),
+          Eq);
+      __m256i Ph = _mm256_or_si256(
+          M, _mm256_xor_si256(_mm256_or_si256(Xh, P), ones));
+      __m256i Mh = _mm256_and_si256(P, Xh);
+      const __m256i hout = _mm256_sub_epi64(_mm256_srli_epi64(Ph, 63),
+                                            _mm256_srli_epi64(Mh, 63));
+      Ph = _mm256_or_si256(_mm256_slli_epi64(Ph, 1), hin_pos);
+      Mh = _mm256_or_si256(_mm256_slli_epi64(Mh, 1), hin_neg);
+      const __m256i newP = _mm256_or_si256(
+          Mh, _mm256_xor_si256(_mm256_or_si256(Xv, Ph), ones));
+      const __m256i newM = _mm256_and_si256(Ph, Xv);
+      P = _mm256_blendv_epi8(P, newP, active);
+      M = _mm256_blendv_epi8(M, newM, active);
+
+      if (s >= 3)
+        carry[s - 3] = _mm256_extract_epi64(hout, 3);
+      // Lane k - 1's bottom delta enters lane k next step.
+      hin = _mm256_permute4x64_epi64(hout, 0x90);
+      chars = _mm256_permute4x64_epi64(chars, 0x90);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(&Pv[b0]), P);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(&Mv[b0]), M);
+  }
+  return last_row(Pv, Mv, p.m, n);
+}
+} // namespace myers_util
+
+// Levenshtein distance of x and y, O(ceil(min(M, N) / 64) max(M, N)) time.
+// variant: 0 picks the single word for patterns of up to 64 characters and
+// AVX2 when the CPU has it; 1 forces the scalar blocks, 2 the AVX2 strips.
+inline size_t edit_distance_myers(const std::string &x, const std::string &y,
+                                  int variant = 0) {
+  using namespace myers_util;
+  const std::string &p = x.length() <= y.length() ? x : y;
+  const std::string &t = x.length() <= y.length() ? y : x;
+  if (p.empty())
+    return t.length();
+  const pattern_t pat(p);
+  if (variant == 1)
+    return distance_blocked(pat, t);
+  if (variant == 2 || (p.length() > 64 && __builtin_cpu_supports("avx2")))
+    return distance_avx2(pat, t);
+  if (p.length() <= 64)
+    return distance_word(pat, t);
+  return distance_blocked(pat, t);
+}
+
+// Least cost to transform x into y: bit-parallel for the unit costs of
+// edit_cost, two DP rows otherwise.
+inline size_t edit_distance(const std::string &x, const std::string &y,
+                            cost_func_t costfunc) {
+  if (&costfunc == &edit_cost)
+    return edit_distance_myers(x, y);
+  return edit_distance_linear(x, y, costfunc);
+}
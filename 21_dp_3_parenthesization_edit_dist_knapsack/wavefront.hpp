@@ -0,0 +1,80 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Lets nthreads threads wait for each other; the last to arrive runs
+// on_complete before releasing the others.
+class wavefront_barrier {
+private:
+  const size_t nthreads;
+  size_t waiting = 0;
+  size_t generation = 0;
+  std::mutex m;
+  std::condition_variable cv;
+
+public:
+  explicit wavefront_barrier(size_t _nthreads) : nthreads(_nthreads) {}
+
+  template <typename F> void arrive_and_wait(F on_complete) {
+    std::unique_lock<std::mutex> lock(m);
+    const size_t gen = generation;
+    if (++waiting == nthreads) {
+      on_complete();
+      waiting = 0;
+      ++generation;
+      cv.notify_all();
+      return;
+    }
+    cv.wait(lock, [&] { return generation != gen; });
+  }
+};
+
+// Runs tile(ti, tj) over a TR x TC grid of tiles, one anti-diagonal
+// ti + tj = t at a time, for DP tables whose cells depend on cells above
+// and to the left: each tile starts after every tile of a lower
+// anti-diagonal, so after every tile above it and to its left. The tiles
+// of an anti-diagonal are independent and taken by nthreads threads from a
+// shared counter; a barrier separates anti-diagonals.
+template <typename TILE>
+void wavefront(size_t TR, size_t TC, size_t nthreads, TILE tile) {
+  if (!TR || !TC)
+    return;
+  if (nthreads <= 1) {
+    for (size_t t = 0; t < TR + TC - 1; ++t)
+      for (size_t ti = t < TC ? 0 : t - TC + 1; ti <= std::min(t, TR - 1);
+           ++ti)
+        tile(ti, t - ti);
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  wavefront_barrier barrier(nthreads);
+  auto work = [&]() {
+    for (size_t t = 0; t < TR + TC - 1; ++t) {
+      const size_t lo = t < TC ? 0 : t - TC + 1;
+      const size_t count = std::min(t, TR - 1) + 1 - lo;
+      for (size_t k; (k = next++) < count;)
+        tile(lo + k, t - lo - k);
+      barrier.arrive_and_wait([&] { next = 0; });
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < nthreads; ++t)
+    workers.emplace_back(work);
+  work();
+  for (auto &w : workers)
+    w.join();
+}
@@ -0,0 +1,414 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "range_min.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Poor man's dynamic subrange min calculator: O(1) update, O(n) query.
+class range_min_brute_force_dynamic : public dynamic_range_min {
+protected:
+  std::vector<uint32_t> vals;
+
+public:
+  range_min_brute_force_dynamic(const uint32_t *_nums, uint32_t _N)
+      : dynamic_range_min(_nums, _N) {}
+
+  virtual void pre_process() override { vals.assign(nums, nums + N); }
+
+  virtual void update(ssize_t idx, uint32_t val) override {
+    if (idx >= 0 && idx < N)
+      vals[idx] = val;
+  }
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+
+    auto lowest = vals[low];
+    for (auto i = low + 1; i <= high; ++i)
+      lowest = std::min(lowest, vals[i]);
+
+    return lowest;
+  }
+};
+
+// Iterative bottom-up segment tree with FANOUT children per node.
+// Level 0 holds the numbers, level l + 1 holds the mins of each group of
+// FANOUT consecutive entries of level l. Every level is padded with
+// INVALID_MIN to a multiple of FANOUT, so a node's children are one
+// contiguous, aligned group: with FANOUT 16 a group of uint32_t is exactly a
+// 64 byte cache line and its min is a fixed length loop the compiler
+// vectorizes.
+// Update: recompute one group min per level, O(FANOUT * log_FANOUT(n)).
+// Query: climb up from both ends, scanning at most one partial group at each
+// end per level, O(FANOUT * log_FANOUT(n)).
+template <uint32_t FANOUT>
+class range_min_segment_tree : public dynamic_range_min {
+protected:
+  // All the levels, bottom up, in one flat array.
+  std::vector<uint32_t> tree;
+
+  // Offset of each level in the flat array.
+  std::vector<size_t> offset;
+
+  static uint32_t group_min(const uint32_t *group) {
+    uint32_t lowest = group[0];
+    for (uint32_t i = 1; i < FANOUT; ++i)
+      lowest = std::min(lowest, group[i]);
+    return lowest;
+  }
+
+  static uint32_t scan_min(const uint32_t *vals, size_t len) {
+    uint32_t lowest = INVALID_MIN;
+    for (size_t i = 0; i < len; ++i)
+      lowest = std::min(lowest, vals[i]);
+    return lowest;
+  }
+
+public:
+  range_min_segment_tree(const uint32_t *_nums, uint32_t _N)
+      : dynamic_range_min(_nums, _N) {}
+
+  virtual void pre_process() override {
+    // Lay out the levels.
+    std::vector<size_t> sizes;
+    size_t total = 0;
+    offset.clear();
+    for (size_t n = std::max<size_t>(N, 1);; n = (n + FANOUT - 1) / FANOUT) {
+      offset.push_back(total);
+      sizes.push_back(n);
+      total += (n + FANOUT - 1) / FANOUT * FANOUT;
+      if (n <= FANOUT)
+        break;
+    }
+
+    tree.assign(total, INVALID_MIN);
+    std::copy(nums, nums + N, tree.begin());
+    for (size_t l = 1; l < offset.size(); ++l)
+      for (size_t j = 0; j < sizes[l]; ++j)
+        tree[offset[l] + j] = group_min(&tree[offset[l - 1] + j * FANOUT]);
+  }
+
+  virtual void update(ssize_t idx, uint32_t val) override {
+    if (idx < 0 || idx >= N)
+      return;
+
+    tree[idx] = val;
+    for (size_t l = 1; l < offset.size(); ++l) {
+      idx /= FANOUT;
+      tree[offset[l] + idx] = group_min(&tree[offset[l - 1] + idx * FANOUT]);
+    }
+  }
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+
+    uint32_t lowest = INVALID_MIN;
+    size_t l = low, h = high;
+    for (size_t lv = 0; l <= h; ++lv) {
+      const uint32_t *row = tree.data() + offset[lv];
+      if (l / FANOUT == h / FANOUT) {
+        // Both ends in the same group.
+        lowest = std::min(lowest, scan_min(row + l, h - l + 1));
+        break;
+      }
+
+      // Partial group at the low end.
+      if (l % FANOUT) {
+        lowest = std::min(lowest, scan_min(row + l, FANOUT - l % FANOUT));
+        l = l / FANOUT + 1;
+      } else
+        l /= FANOUT;
+
+      // Partial group at the high end. Here h / FANOUT > l / FANOUT >= 0.
+      if ((h + 1) % FANOUT) {
+        lowest =
+            std::min(lowest, scan_min(row + h - h % FANOUT, h % FANOUT + 1));
+        h = h / FANOUT - 1;
+      } else
+        h /= FANOUT;
+    }
+
+    return lowest;
+  }
+};
+
+// Recursive binary segment tree with lazy propagation, for range assignment
+// in O(lg n).
+// An assigned subrange is recorded as a pending tag at the O(lg n) nodes that
+// cover it and pushed down to the children only when a later assignment
+// splits such a node. Queries never push: a node carrying a tag covers a
+// subrange whose numbers are all equal to the tag, so the query stops there.
+class range_min_lazy_segment_tree : public dynamic_range_min {
+protected:
+  std::vector<uint32_t> mins;
+
+  std::vector<uint32_t> tag;
+
+  std::vector<uint8_t> has_tag;
+
+  void build(size_t node, ssize_t nl, ssize_t nr) {
+    has_tag[node] = 0;
+    if (nl == nr) {
+      mins[node] = nums[nl];
+      return;
+    }
+    ssize_t mid = (nl + nr) / 2;
+    build(2 * node, nl, mid);
+    build(2 * node + 1, mid + 1, nr);
+    mins[node] = std::min(mins[2 * node], mins[2 * node + 1]);
+  }
+
+  void apply_tag(size_t node, uint32_t val) {
+    mins[node] = val;
+    tag[node] = val;
+    has_tag[node] = 1;
+  }
+
+  void push_down(size_t node) {
+    if (has_tag[node]) {
+      apply_tag(2 * node, tag[node]);
+      apply_tag(2 * node + 1, tag[node]);
+      has_tag[node] = 0;
+    }
+  }
+
+  void assign(size_t node, ssize_t nl, ssize_t nr, ssize_t low, ssize_t high,
+              uint32_t val) {
+    if (high < nl || nr < low)
+      return;
+    if (low <= nl && nr <= high) {
+      apply_tag(node, val);
+      return;
+    }
+    push_down(node);
+    ssize_t mid = (nl + nr) / 2;
+    assign(2 * node, nl, mid, low, high, val);
+    assign(2 * node + 1, mid + 1, nr, low, high, val);
+    mins[node] = std::min(mins[2 * node], mins[2 * node + 1]);
+  }
+
+  uint32_t query(size_t node, ssize_t nl, ssize_t nr, ssize_t low,
+                 ssize_t high) const {
+    if (high < nl || nr < low)
+      return INVALID_MIN;
+    if ((low <= nl && nr <= high) || has_tag[node])
+      return mins[node];
+    ssize_t mid = (nl + nr) / 2;
+    return std::min(query(2 * node, nl, mid, low, high),
+                    query(2 * node + 1, mid + 1, nr, low, high));
+  }
+
+public:
+  range_min_lazy_segment_tree(const uint32_t *_nums, uint32_t _N)
+      : dynamic_range_min(_nums, _N) {}
+
+  virtual void pre_process() override {
+    if (N == 0)
+      return;
+    mins.assign(4 * N, INVALID_MIN);
+    tag.assign(4 * N, 0);
+    has_tag.assign(4 * N, 0);
+    build(1, 0, N - 1);
+  }
+
+  virtual void update(ssize_t idx, uint32_t val) override {
+    assign_range(idx, idx, val);
+  }
+
+  virtual void assign_range(ssize_t low, ssize_t high,
+                            uint32_t val) override {
+    if (low > high || low < 0 || high >= N)
+      return;
+    assign(1, 0, N - 1, low, high, val);
+  }
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+    return query(1, 0, N - 1, low, high);
+  }
+};
+
+// A pre-generated operation of a mixed workload.
+struct range_op_t {
+  enum { QUERY, UPDATE, ASSIGN } kind;
+  ssize_t low;
+  ssize_t high;
+  uint32_t val;
+};
+
+// update_pct percent of the operations modify the numbers: point updates, or
+// range assignments of up to max_assign_len numbers if max_assign_len > 0.
+std::vector<range_op_t> make_workload(uint32_t N, size_t nops, int update_pct,
+                                      uint32_t max_assign_len) {
+  std::vector<range_op_t> ops(nops);
+  for (auto &op : ops) {
+    if (rand() % 100 < update_pct) {
+      op.low = rand() % N;
+      if (max_assign_len) {
+        op.kind = range_op_t::ASSIGN;
+        op.high = std::min<ssize_t>(N - 1, op.low + rand() % max_assign_len);
+      } else {
+        op.kind = range_op_t::UPDATE;
+        op.high = op.low;
+      }
+      op.val = rand() % (4 * N);
+    } else {
+      op.kind = range_op_t::QUERY;
+      op.low = rand() % N;
+      op.high = rand() % N;
+      if (op.low > op.high)
+        std::swap(op.low, op.high);
+    }
+  }
+  return ops;
+}
+
+// Runs the workload; returns a checksum of the query results.
+uint64_t run_workload(dynamic_range_min &rmin,
+                      const std::vector<range_op_t> &ops) {
+  uint64_t checksum = 0;
+  for (const auto &op : ops) {
+    switch (op.kind) {
+    case range_op_t::UPDATE:
+      rmin.update(op.low, op.val);
+      break;
+    case range_op_t::ASSIGN:
+      rmin.assign_range(op.low, op.high, op.val);
+      break;
+    case range_op_t::QUERY:
+    default:
+      checksum += rmin.find_range_min(op.low, op.high);
+      break;
+    }
+  }
+  return checksum;
+}
+
+// Returns throughput in million operations per second.
+double run_benchmark(dynamic_range_min &rmin,
+                     const std::vector<range_op_t> &ops, uint64_t &checksum) {
+  rmin.pre_process();
+  auto t1 = std::chrono::high_resolution_clock::now();
+  checksum = run_workload(rmin, ops);
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return ops.size() /
+         (std::chrono::duration<double, std::milli>(t2 - t1).count() * 1000.0);
+}
+
+// Compare an implementation against the brute-force on a mixed workload.
+bool verify_dynamic_range_min(dynamic_range_min &rmin, const uint32_t *nums,
+                              uint32_t N, uint32_t max_assign_len) {
+  range_min_brute_force_dynamic rbf(nums, N);
+  rbf.pre_process();
+  rmin.pre_process();
+  auto ops = make_workload(N, 100000, 30, max_assign_len);
+  for (const auto &op : ops) {
+    if (op.kind == range_op_t::QUERY) {
+      if (rmin.find_range_min(op.low, op.high) !=
+          rbf.find_range_min(op.low, op.high))
+        return false;
+    } else {
+      rmin.assign_range(op.low, op.high, op.val);
+      rbf.assign_range(op.low, op.high, op.val);
+    }
+  }
+  return true;
+}
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  const uint32_t N = 1 << 20;
+  std::vector<uint32_t> nums(N);
+  for (auto &x : nums)
+    x = rand() % (4 * N);
+
+  // Verify on a small, odd sized array so that partial groups are covered.
+  const uint32_t VN = 1000;
+  range_min_segment_tree<2> vst2(nums.data(), VN);
+  range_min_segment_tree<8> vst8(nums.data(), VN);
+  range_min_segment_tree<16> vst16(nums.data(), VN);
+  range_min_lazy_segment_tree vlst(nums.data(), VN);
+  std::cout << "Verification: "
+            << ((verify_dynamic_range_min(vst2, nums.data(), VN, 0) &&
+                 verify_dynamic_range_min(vst8, nums.data(), VN, 0) &&
+                 verify_dynamic_range_min(vst16, nums.data(), VN, 50) &&
+                 verify_dynamic_range_min(vlst, nums.data(), VN, 0) &&
+                 verify_dynamic_range_min(vlst, nums.data(), VN, 200))
+                    ? "PASS"
+                    : "FAIL")
+            << std::endl
+            << std::endl;
+
+  const size_t NOPS = 1000000;
+
+  // Point updates mixed with queries on random subranges.
+  std::cout << "Point update / query throughput (Mops/s), length: " << N
+            << std::endl;
+  std::cout << "update%      binary       8-ary      16-ary        lazy"
+            << std::endl;
+  for (int update_pct : {0, 10, 50, 90}) {
+    auto ops = make_workload(N, NOPS, update_pct, 0);
+    range_min_segment_tree<2> st2(nums.data(), N);
+    range_min_segment_tree<8> st8(nums.data(), N);
+    range_min_segment_tree<16> st16(nums.data(), N);
+    range_min_lazy_segment_tree lst(nums.data(), N);
+    uint64_t c2, c8, c16, cl;
+    auto m2 = run_benchmark(st2, ops, c2);
+    auto m8 = run_benchmark(st8, ops, c8);
+    auto m16 = run_benchmark(st16, ops, c16);
+    auto ml = run_benchmark(lst, ops, cl);
+    std::cout.width(7);
+    std::cout << update_pct;
+    for (auto m : {m2, m8, m16, ml}) {
+      std::cout.width(12);
+      std::cout << m;
+    }
+    std::cout << ((c2 == c8 && c8 == c16 && c16 == cl) ? "" : "  MISMATCH")
+              << std::endl;
+  }
+
+  // Range assignments of up to 1000 numbers mixed with queries.
+  std::cout << std::endl
+            << "Range assign / query throughput (Mops/s), length: " << N
+            << std::endl;
+  std::cout << "assign%      16-ary        lazy" << std::endl;
+  for (int update_pct : {10, 50, 90}) {
+    auto ops = make_workload(N, NOPS / 10, update_pct, 1000);
+    range_min_segment_tree<16> st16(nums.data(), N);
+    range_min_lazy_segment_tree lst(nums.data(), N);
+    uint64_t c16, cl;
+    auto m16 = run_benchmark(st16, ops, c16);
+    auto ml = run_benchmark(lst, ops, cl);
+    std::cout.width(7);
+    std::cout << update_pct;
+    for (auto m : {m16, ml}) {
+      std::cout.width(12);
+      std::cout << m;
+    }
+    std::cout << ((c16 == cl) ? "" : "  MISMATCH") << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "range_min.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Random subranges of length 1 to max_len.
+std::vector<range_query_t> make_queries(uint32_t N, size_t nqueries,
+                                        uint32_t max_len) {
+  std::vector<range_query_t> queries(nqueries);
+  for (auto &q : queries) {
+    q.low = rand() % N;
+    q.high = std::min<ssize_t>(N - 1, q.low + rand() % max_len);
+  }
+  return queries;
+}
+
+// Throughput of answering the queries one find_range_min call at a time, in
+// million queries per second.
+double run_loop_test(const range_min &rmin,
+                     const std::vector<range_query_t> &queries,
+                     std::vector<uint32_t> &results) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < queries.size(); ++i)
+    results[i] = rmin.find_range_min(queries[i].low, queries[i].high);
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return queries.size() /
+         (std::chrono::duration<double, std::milli>(t2 - t1).count() * 1000.0);
+}
+
+// Throughput of answering the queries with one find_range_min_batch call.
+double run_batch_test(const range_min &rmin,
+                      const std::vector<range_query_t> &queries,
+                      std::vector<uint32_t> &results) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  rmin.find_range_min_batch(queries.data(), queries.size(), results.data());
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return queries.size() /
+         (std::chrono::duration<double, std::milli>(t2 - t1).count() * 1000.0);
+}
+
+void print_result(const std::string &msg, double mqps,
+                  const std::vector<uint32_t> &results,
+                  const std::vector<uint32_t> &expected) {
+  std::cout.width(34);
+  std::cout << msg;
+  std::cout.width(12);
+  std::cout << mqps << ((results == expected) ? "" : "  MISMATCH")
+            << std::endl;
+}
+
+int main() {
+  srand(A_BIG_PRIME_NUMBER);
+
+  const uint32_t N = 1 << 22;
+  std::vector<uint32_t> nums(N);
+  for (auto &x : nums)
+    x = rand() % (4 * N);
+
+  const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+  const size_t NQUERIES = 1 << 21;
+
+  range_min_sparse_table rst(nums.data(), N);
+  rst.pre_process();
+  range_min_block rb(nums.data(), N);
+  rb.pre_process();
+  range_min_hybrid rh(nums.data(), N);
+  rh.pre_process();
+  range_min_simd_brute_force rsbf(nums.data(), N);
+
+  for (uint32_t max_len : {N, 32u, 16u}) {
+    auto queries = make_queries(N, NQUERIES, max_len);
+    std::vector<uint32_t> expected(queries.size()), results(queries.size());
+
+    std::cout << "Queries: " << queries.size() << ", length: " << N
+              << ", max subrange length: " << max_len << ", threads: " << hw
+              << std::endl;
+    std::cout << "                            method   Mqueries/s" << std::endl;
+
+    // Reference answers; the sparse table is verified against the
+    // brute-force in m6006_r11_01_range_min.
+    run_loop_test(rst, queries, expected);
+
+    // Scanning is only sensible for short subranges.
+    std::vector<std::pair<std::string, const range_min *>> engines = {
+        {"sparse-table", &rst}, {"block", &rb}, {"hybrid", &rh}};
+    if (max_len <= 1024)
+      engines.push_back({"simd brute-force", &rsbf});
+
+    for (const auto &e : engines) {
+      auto mqps = run_loop_test(*e.second, queries, results);
+      print_result(e.first + " loop", mqps, results, expected);
+
+      mqps = run_batch_test(*e.second, queries, results);
+      print_result(e.first + " batch", mqps, results, expected);
+
+      range_min_batch par(*e.second, hw, false);
+      mqps = run_batch_test(par, queries, results);
+      print_result(e.first + " batch par", mqps, results, expected);
+
+      range_min_batch sorted_par(*e.second, hw, true);
+      mqps = run_batch_test(sorted_par, queries, results);
+      print_result(e.first + " batch sorted par", mqps, results, expected);
+    }
+
+    std::cout << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,555 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RANGE_MIN_X86_SIMD
+#endif
+
+#define INVALID_MIN UINT32_MAX
+
+// Longest subrange of the branch-free short scan, which always reads this
+// many numbers.
+#define SHORT_SCAN_LEN 16
+
+// A subrange query, for the batch API.
+struct range_query_t {
+  ssize_t low;
+  ssize_t high;
+};
+
+namespace range_min_util {
+
+// Min of len numbers; INVALID_MIN if len is 0.
+inline uint32_t scan_min_scalar(const uint32_t *vals, size_t len) {
+  uint32_t lowest = INVALID_MIN;
+  for (size_t i = 0; i < len; ++i)
+    lowest = std::min(lowest, vals[i]);
+  return lowest;
+}
+
+#ifdef RANGE_MIN_X86_SIMD
+// 16 uint32_t lanes per iteration in two 8 lane AVX2 registers. Compiled for
+// AVX2 irrespective of the build flags; only called if the CPU supports it.
+__attribute__((target("avx2"))) inline uint32_t
+scan_min_avx2(const uint32_t *vals, size_t len) {
+  __m256i lo8 = _mm256_set1_epi32(-1), hi8 = lo8;
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    lo8 = _mm256_min_epu32(
+        lo8, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vals + i)));
+    hi8 = _mm256_min_epu32(
+        hi8,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vals + i + 8)));
+  }
+  if (i + 8 <= len) {
+    lo8 = _mm256_min_epu32(
+        lo8, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vals + i)));
+    i += 8;
+  }
+
+  // Horizontal min: 16 -> 8 -> 4 -> 2 -> 1 lanes.
+  lo8 = _mm256_min_epu32(lo8, hi8);
+  __m128i lowest4 = _mm_min_epu32(_mm256_castsi256_si128(lo8),
+                                  _mm256_extracti128_si256(lo8, 1));
+  lowest4 = _mm_min_epu32(lowest4, _mm_shuffle_epi32(lowest4, 0x4E));
+  lowest4 = _mm_min_epu32(lowest4, _mm_shuffle_epi32(lowest4, 0xB1));
+  uint32_t lowest = static_cast<uint32_t>(_mm_cvtsi128_si32(lowest4));
+
+  for (; i < len; ++i)
+    lowest = std::min(lowest, vals[i]);
+  return lowest;
+}
+
+// Min of the first len numbers, 1 <= len <= SHORT_SCAN_LEN, of
+// SHORT_SCAN_LEN readable ones. The lanes from len on are masked to all ones
+// instead of looping over them, so random lengths cost no mispredicted
+// branches.
+__attribute__((target("avx2"))) inline uint32_t
+scan_short_min_avx2(const uint32_t *vals, size_t len) {
+  // All ones in the lanes past len: lane + 1 > len.
+  const __m256i n = _mm256_set1_epi32(static_cast<int>(len));
+  const __m256i past_lo =
+      _mm256_cmpgt_epi32(_mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8), n);
+  const __m256i past_hi =
+      _mm256_cmpgt_epi32(_mm256_setr_epi32(9, 10, 11, 12, 13, 14, 15, 16), n);
+  __m256i lo8 = _mm256_or_si256(
+      past_lo, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vals)));
+  __m256i hi8 = _mm256_or_si256(
+      past_hi,
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vals + 8)));
+
+  lo8 = _mm256_min_epu32(lo8, hi8);
+  __m128i lowest4 = _mm_min_epu32(_mm256_castsi256_si128(lo8),
+                                  _mm256_extracti128_si256(lo8, 1));
+  lowest4 = _mm_min_epu32(lowest4, _mm_shuffle_epi32(lowest4, 0x4E));
+  lowest4 = _mm_min_epu32(lowest4, _mm_shuffle_epi32(lowest4, 0xB1));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(lowest4));
+}
+#endif
+
+typedef uint32_t (*scan_min_func_t)(const uint32_t *, size_t);
+
+// Widest vector implementation supported by the CPU, picked once.
+inline scan_min_func_t select_scan_min() {
+#ifdef RANGE_MIN_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return scan_min_avx2;
+#endif
+  return scan_min_scalar;
+}
+
+inline uint32_t scan_min(const uint32_t *vals, size_t len) {
+  static const scan_min_func_t impl = select_scan_min();
+  return impl(vals, len);
+}
+
+// The branch-free short scan if the CPU supports it, nullptr otherwise: a
+// scalar loop over short subranges loses to the sparse table.
+inline scan_min_func_t select_scan_short_min() {
+#ifdef RANGE_MIN_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return scan_short_min_avx2;
+#endif
+  return nullptr;
+}
+
+} // namespace range_min_util
+
+// Intarface class to calculate the minimum within a subrange of an array.
+class range_min {
+
+public:
+  range_min(const uint32_t *_nums, uint32_t _N) : nums(_nums), N(_N) {}
+
+  virtual ~range_min() {}
+
+  virtual void pre_process() {}
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const = 0;
+
+  // Answers a batch of queries: results[i] is the min of queries[i].
+  // Implementations may reorder or parallelize the work.
+  virtual void find_range_min_batch(const range_query_t *queries,
+                                    size_t nqueries, uint32_t *results) const {
+    for (size_t i = 0; i < nqueries; ++i)
+      results[i] = find_range_min(queries[i].low, queries[i].high);
+  }
+
+  uint32_t length() const { return N; }
+
+protected:
+  const uint32_t *nums;
+
+  uint32_t N;
+};
+
+// Interface class for the range min calculators that allow the numbers to be
+// modified after pre-processing. Implementations keep their own copy of the
+// numbers; the array passed to the constructor is only read by pre_process().
+class dynamic_range_min : public range_min {
+
+public:
+  dynamic_range_min(const uint32_t *_nums, uint32_t _N)
+      : range_min(_nums, _N) {}
+
+  // Set the number at index idx to val.
+  virtual void update(ssize_t idx, uint32_t val) = 0;
+
+  // Set all the numbers in the subrange (low, high) to val.
+  virtual void assign_range(ssize_t low, ssize_t high, uint32_t val) {
+    for (auto i = low; i <= high; ++i)
+      update(i, val);
+  }
+};
+
+// Calculates the minimum within a subrange of an array using a
+// divide-and-conquer method. It pre-calculates O(n*log(n)) subranges by
+// recursively dividing the array into two subarray halves and saving, in a
+// hash-map, the mins of the sub-ranges
+// {(i, mid)} : start <= i <= mid; and {(mid+1, j)} mid+1 <= j <= end.
+// While calculating the minimum for a sub-range (i, j), subsequent mid points
+// of sub-arrays are calculated till a mid point is found such that i and j are
+// at either side of mid. min(subrange_min(i, mid), subrange_min(mid+1, j))
+// is the minimum for subrange (i, j).
+class range_min_dc : public range_min {
+protected:
+  struct pair_hash {
+    template <class T1, class T2>
+    size_t operator()(const std::pair<T1, T2> &p) const {
+      return (std::hash<T1>{}(p.first) ^ std::hash<T2>{}(p.second));
+    }
+  };
+
+  typedef std::unordered_map<std::pair<ssize_t, ssize_t>, uint32_t, pair_hash>
+      range_min_table_t;
+
+  range_min_table_t rtable;
+
+  void populate_min_range_table_recurse(ssize_t low, ssize_t high) {
+    // Base cases.
+    if (low > high) {
+      return;
+    }
+    if (low == high) {
+      rtable[std::make_pair(low, high)] = nums[low];
+      return;
+    }
+
+    ssize_t mid = (low + high) / 2;
+
+    // Left half:
+    // Pre-calculate min of sub-ranges (low, mid), (low+1, mid), ... (mid, mid)
+    uint32_t lowest = nums[mid];
+    for (auto i = mid; i >= low; --i) {
+      lowest = std::min(lowest, nums[i]);
+      rtable[std::make_pair(i, mid)] = lowest;
+    }
+    // Right half:
+    // Pre-calculate min of sub-ranges (mid+1, mid+1), ... (mid+1, high-1),
+    // (mid+1, high)
+    lowest = nums[mid + 1];
+    for (auto i = mid + 1; i <= high; ++i) {
+      lowest = std::min(lowest, nums[i]);
+      rtable[std::make_pair(mid + 1, i)] = lowest;
+    }
+
+    // Recurse.
+    populate_min_range_table_recurse(low, mid);
+    populate_min_range_table_recurse(mid + 1, high);
+  }
+
+public:
+  range_min_dc(const uint32_t *_nums, uint32_t _N) : range_min(_nums, _N) {}
+
+  virtual void pre_process() override {
+    populate_min_range_table_recurse(0, N - 1);
+  }
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+    // Trivial range.
+    if (low == high) {
+      return nums[low];
+    }
+
+    ssize_t ll = 0, hh = N - 1;
+    while (ll < hh) {
+      auto mid = (ll + hh) / 2;
+      if (low <= mid && high > mid) {
+        // low and high are at either side of mid.
+        // minimum of subrange mins of the subranges (low, mid) and
+        // (mid+1, high) is the answer.
+        auto itrl = rtable.find(std::make_pair(low, mid));
+        if (itrl == rtable.end()) {
+          assert(false);
+          return INVALID_MIN;
+        }
+        auto itrr = rtable.find(std::make_pair(mid + 1, high));
+        if (itrr == rtable.end()) {
+          assert(false);
+          return INVALID_MIN;
+        }
+        return std::min(itrl->second, itrr->second);
+      } else if (high <= mid) {
+        // Both low and high are on the left half; try there.
+        hh = mid;
+      } else {
+        // Both low and high are on the right half; try there.
+        ll = mid + 1;
+      }
+    }
+
+    assert(false);
+    return INVALID_MIN;
+  }
+
+  void dump_rtable(std::ostream &os) const {
+    for (const auto &e : rtable)
+      os << "[" << e.first.first << " : " << e.first.second
+         << "] = " << e.second << std::endl;
+  }
+};
+
+// Poor man's subrange min calculator.
+class range_min_brute_force : public range_min {
+public:
+  range_min_brute_force(const uint32_t *_nums, uint32_t _N)
+      : range_min(_nums, _N) {}
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+
+    auto lowest = nums[low];
+    for (auto i = low + 1; i <= high; ++i)
+      lowest = std::min(lowest, nums[i]);
+
+    return lowest;
+  }
+};
+
+// Sparse table: pre-calculates the mins of all the subranges of length
+// 2^k starting at each index i into a flat array, table[k * N + i].
+// A subrange (low, high) is covered by two, possibly overlapping, subranges of
+// length 2^k, where k = floor(lg(high - low + 1)); so a query is O(1).
+// O(n lg n) space and pre-processing time.
+class range_min_sparse_table : public range_min {
+protected:
+  std::vector<uint32_t> table;
+
+  static uint32_t floor_log2(uint32_t x) { return 31 - __builtin_clz(x); }
+
+public:
+  range_min_sparse_table(const uint32_t *_nums, uint32_t _N)
+      : range_min(_nums, _N) {}
+
+  virtual void pre_process() override {
+    if (N == 0)
+      return;
+
+    const uint32_t levels = floor_log2(N) + 1;
+    table.resize(static_cast<size_t>(levels) * N);
+    std::copy(nums, nums + N, table.begin());
+
+    for (uint32_t k = 1; k < levels; ++k) {
+      const uint32_t *prev = table.data() + static_cast<size_t>(k - 1) * N;
+      uint32_t *cur = table.data() + static_cast<size_t>(k) * N;
+      const uint32_t half = 1u << (k - 1);
+      for (uint32_t i = 0; i + 2 * half <= N; ++i)
+        cur[i] = std::min(prev[i], prev[i + half]);
+    }
+  }
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+
+    const uint32_t k = floor_log2(high - low + 1);
+    const uint32_t *row = table.data() + static_cast<size_t>(k) * N;
+    return std::min(row[low], row[high - (1 << k) + 1]);
+  }
+};
+
+// Block decomposition: O(n) space and pre-processing time, O(1) query.
+// The array is split into blocks of 32 numbers.
+// - Across blocks: a sparse table over the block mins; only O(n / 32 *
+//   lg(n / 32)) entries.
+// - Within a block: for each index i, a 32-bit mask of the positions in
+//   the block (up to i) that are on the monotonic stack of increasing mins
+//   ending at i. The min of the subrange (low, i) of the block is at the
+//   lowest set bit of the mask at i that is not before low.
+class range_min_block : public range_min {
+protected:
+  static const uint32_t BLOCK = 32;
+
+  std::vector<uint32_t> masks;
+
+  std::vector<uint32_t> block_mins;
+
+  std::unique_ptr<range_min_sparse_table> block_rmq;
+
+  uint32_t in_block_min(ssize_t low, ssize_t high) const {
+    const ssize_t start = low - (low % BLOCK);
+    const uint32_t m = masks[high] & (~0u << (low - start));
+    return nums[start + __builtin_ctz(m)];
+  }
+
+public:
+  range_min_block(const uint32_t *_nums, uint32_t _N) : range_min(_nums, _N) {}
+
+  virtual void pre_process() override {
+    masks.resize(N);
+    block_mins.assign((N + BLOCK - 1) / BLOCK, INVALID_MIN);
+
+    for (uint32_t start = 0; start < N; start += BLOCK) {
+      const uint32_t end = std::min(start + BLOCK, N);
+      uint32_t stack = 0;
+      for (uint32_t i = start; i < end; ++i) {
+        // Pop the larger numbers from the top (the highest set bit).
+        while (stack && nums[start + 31 - __builtin_clz(stack)] > nums[i])
+          stack ^= 1u << (31 - __builtin_clz(stack));
+        stack |= 1u << (i - start);
+        masks[i] = stack;
+      }
+      block_mins[start / BLOCK] =
+          nums[start + __builtin_ctz(masks[end - 1])];
+    }
+
+    block_rmq.reset(
+        new range_min_sparse_table(block_mins.data(), block_mins.size()));
+    block_rmq->pre_process();
+  }
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+
+    const ssize_t bl = low / BLOCK, bh = high / BLOCK;
+    if (bl == bh)
+      return in_block_min(low, high);
+
+    // Suffix of the low block, prefix of the high block and the full
+    // blocks in between.
+    auto lowest = std::min(in_block_min(low, (bl + 1) * BLOCK - 1),
+                           in_block_min(bh * BLOCK, high));
+    if (bl + 1 < bh)
+      lowest = std::min(lowest, block_rmq->find_range_min(bl + 1, bh - 1));
+    return lowest;
+  }
+};
+
+// Brute-force with vector instructions: no pre-processing and O(n / 8)
+// per query. Even on short random subranges it at best ties a sparse table
+// lookup, whose two reads usually miss the cache no more than the scan
+// does, while the loops over the scan's random length mispredict.
+class range_min_simd_brute_force : public range_min {
+public:
+  range_min_simd_brute_force(const uint32_t *_nums, uint32_t _N)
+      : range_min(_nums, _N) {}
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // Invalid ranges.
+    if (low > high || low < 0 || high >= N) {
+      return INVALID_MIN;
+    }
+    return range_min_util::scan_min(nums + low, high - low + 1);
+  }
+};
+
+// Sparse table, with the branch-free AVX2 scan for subranges of up to
+// SHORT_SCAN_LEN numbers; the sparse table alone without AVX2. Built with
+// -O2, the scan answers such random subranges about 1.3 to 1.6 times as fast
+// as the table, and longer scans lose; built without optimization, as by
+// common.mk, the intrinsics are not inlined and the table wins throughout.
+class range_min_hybrid : public range_min_sparse_table {
+protected:
+  const range_min_util::scan_min_func_t scan_short;
+
+public:
+  range_min_hybrid(const uint32_t *_nums, uint32_t _N)
+      : range_min_sparse_table(_nums, _N),
+        scan_short(range_min_util::select_scan_short_min()) {}
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    // As unsigned, a negative low is past N and a high below low makes a
+    // too long subrange.
+    const size_t start = low, len = static_cast<size_t>(high) - low + 1;
+    if (scan_short && len <= SHORT_SCAN_LEN && start < N &&
+        N - start >= SHORT_SCAN_LEN)
+      return scan_short(nums + low, len);
+    return range_min_sparse_table::find_range_min(low, high);
+  }
+};
+
+// Batch query engine wrapping another range min calculator.
+// - Offline ordering (sort_by_block): the queries are counting-sorted by the
+//   block of BLOCK numbers their low end falls in, so that consecutive
+//   queries touch the same part of the array and of the inner tables. The
+//   answers are scattered back to the original positions at the end. This
+//   costs three extra passes over the batch, so it pays off only when the
+//   inner tables are much larger than the cache and the batch is dense
+//   enough per block.
+// - Parallel: the (ordered) batch is split into one contiguous chunk per
+//   thread. find_range_min is const, so the inner calculator is shared.
+class range_min_batch : public range_min {
+protected:
+  static const uint32_t BLOCK = 16384;
+
+  const range_min &inner;
+
+  const size_t nthreads;
+
+  const bool sort_by_block;
+
+  // Runs func(from, to) on nthreads contiguous chunks of [0, n).
+  template <typename FUNC> void run_chunks(size_t n, FUNC func) const {
+    if (nthreads == 1 || n < nthreads) {
+      func(0, n);
+      return;
+    }
+
+    std::vector<std::thread> workers;
+    const size_t chunk = (n + nthreads - 1) / nthreads;
+    for (size_t from = 0; from < n; from += chunk)
+      workers.emplace_back(func, from, std::min(n, from + chunk));
+    for (auto &w : workers)
+      w.join();
+  }
+
+public:
+  range_min_batch(const range_min &_inner, size_t _nthreads,
+                  bool _sort_by_block)
+      : range_min(nullptr, _inner.length()), inner(_inner),
+        nthreads(std::max<size_t>(1, _nthreads)),
+        sort_by_block(_sort_by_block) {}
+
+  virtual uint32_t find_range_min(ssize_t low, ssize_t high) const override {
+    return inner.find_range_min(low, high);
+  }
+
+  virtual void find_range_min_batch(const range_query_t *queries,
+                                    size_t nqueries,
+                                    uint32_t *results) const override {
+    if (!sort_by_block) {
+      run_chunks(nqueries, [&](size_t from, size_t to) {
+        inner.find_range_min_batch(queries + from, to - from, results + from);
+      });
+      return;
+    }
+
+    // Counting sort of the queries by block; out of range lows go to the
+    // first block and are rejected by the inner calculator.
+    const size_t nblocks = N / BLOCK + 1;
+    auto block_of = [this](const range_query_t &q) -> size_t {
+      return (q.low >= 0 && q.low < N) ? q.low / BLOCK : 0;
+    };
+    std::vector<size_t> pos(nblocks + 1, 0);
+    for (size_t i = 0; i < nqueries; ++i)
+      ++pos[block_of(queries[i]) + 1];
+    for (size_t b = 0; b < nblocks; ++b)
+      pos[b + 1] += pos[b];
+
+    std::vector<range_query_t> sorted(nqueries);
+    std::vector<size_t> where(nqueries);
+    for (size_t i = 0; i < nqueries; ++i) {
+      const size_t k = pos[block_of(queries[i])]++;
+      sorted[k] = queries[i];
+      where[k] = i;
+    }
+
+    std::vector<uint32_t> sorted_results(nqueries);
+    run_chunks(nqueries, [&](size_t from, size_t to) {
+      inner.find_range_min_batch(sorted.data() + from, to - from,
+                                 sorted_results.data() + from);
+      for (size_t k = from; k < to; ++k)
+        results[where[k]] = sorted_results[k];
+    });
+  }
+};
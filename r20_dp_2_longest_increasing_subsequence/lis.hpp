@@ -0,0 +1,102 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Longest subsequences in which each element comes before the next by
+// comparator CMP: std::less for strictly increasing ones, std::less_equal
+// for non-decreasing ones, std::greater for strictly decreasing ones.
+//
+// Patience sorting: the elements are dealt in order onto piles, each onto
+// the leftmost pile whose top does not come before it, or onto a new pile
+// on the right. Pile k holds the smallest last element of the subsequences
+// of length k + 1 found so far, so the tops are ordered by CMP and the pile
+// is found by binary search; the number of piles is the length of the
+// longest subsequence. O(N log L) time for a longest subsequence of L.
+
+namespace lis_util {
+// Pile of x among the tops.
+template <typename T, typename CMP>
+size_t pile(const std::vector<T> &tops, const T &x, CMP cmp) {
+  return std::partition_point(tops.begin(), tops.end(),
+                              [&](const T &top) { return cmp(top, x); }) -
+         tops.begin();
+}
+
+// Indices of a longest subsequence into seq, with IDX wide enough for N.
+// Each element links to the top of the pile on its left when dealt, the
+// element before it in a longest subsequence ending at it; the last pile's
+// top ends a longest one.
+template <typename IDX, typename T, typename CMP>
+void longest_subseq(const T *nums, size_t N, std::vector<size_t> &seq,
+                    CMP cmp) {
+  std::vector<T> tops;
+  std::vector<IDX> top_index;
+  std::vector<IDX> pred(N);
+  for (size_t i = 0; i < N; ++i) {
+    const size_t k = pile(tops, nums[i], cmp);
+    pred[i] = k ? top_index[k - 1] : static_cast<IDX>(i);
+    if (k == tops.size()) {
+      tops.push_back(nums[i]);
+      top_index.push_back(static_cast<IDX>(i));
+    } else {
+      tops[k] = nums[i];
+      top_index[k] = static_cast<IDX>(i);
+    }
+  }
+
+  seq.resize(tops.size());
+  if (tops.empty())
+    return;
+  size_t i = top_index.back();
+  for (size_t k = seq.size(); k-- > 0; i = pred[i])
+    seq[k] = i;
+}
+} // namespace lis_util
+
+// Indices of a longest subsequence of nums[0 ... N - 1] ordered by cmp, in
+// increasing order; returns its length.
+template <typename T, typename CMP = std::less<T>>
+size_t longest_increasing_subseq(const T *nums, size_t N,
+                                 std::vector<size_t> &seq, CMP cmp = CMP()) {
+  if (N <= UINT32_MAX)
+    lis_util::longest_subseq<uint32_t>(nums, N, seq, cmp);
+  else
+    lis_util::longest_subseq<size_t>(nums, N, seq, cmp);
+  return seq.size();
+}
+
+// Length of the longest subsequence ordered by CMP of the elements pushed so
+// far, kept online in O(L) space: only the pile tops.
+template <typename T, typename CMP = std::less<T>> class lis_stream {
+private:
+  std::vector<T> tops;
+  CMP cmp;
+
+public:
+  explicit lis_stream(CMP _cmp = CMP()) : cmp(_cmp) {}
+
+  // Deals x; returns the length so far.
+  size_t push(const T &x) {
+    const size_t k = lis_util::pile(tops, x, cmp);
+    if (k == tops.size())
+      tops.push_back(x);
+    else
+      tops[k] = x;
+    return tops.size();
+  }
+
+  size_t length() const { return tops.size(); }
+
+  // The smallest last element of a longest subsequence so far; length() > 0.
+  const T &last() const { return tops.back(); }
+};
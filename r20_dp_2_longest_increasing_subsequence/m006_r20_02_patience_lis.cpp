@@ -0,0 +1,177 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lis.hpp"
+
+#define A_BIG_PRIME_NUMBER 2147483647 // srand seed
+
+// Most elements of the benchmark; 100000000 for the 1e8 benchmark.
+#define DEFAULT_SIZE 10000000
+
+// Longest sequences given to the quadratic DP.
+#define QUADRATIC_MAX_SIZE 20000
+
+// Random sequences checked against the quadratic DP.
+#define TEST_COUNT 2000
+#define MAX_TEST_LENGTH 40
+#define MAX_TEST_VALUE 10
+
+double elapsed_ms(std::chrono::high_resolution_clock::time_point t1) {
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+// Length of the longest subsequence ordered by cmp by the O(N^2) DP: the
+// longest ending at each element extends the longest ending at an earlier
+// element that comes before it.
+template <typename T, typename CMP>
+size_t quadratic_lis(const std::vector<T> &nums, CMP cmp) {
+  std::vector<size_t> len(nums.size(), 1);
+  size_t best = 0;
+  for (size_t i = 0; i < nums.size(); ++i) {
+    for (size_t j = 0; j < i; ++j)
+      if (cmp(nums[j], nums[i]))
+        len[i] = std::max(len[i], len[j] + 1);
+    best = std::max(best, len[i]);
+  }
+  return best;
+}
+
+// Whether seq is a subsequence of nums ordered by cmp of the given length,
+// and lis_stream agrees on the length.
+template <typename T, typename CMP>
+bool check(const std::vector<T> &nums, CMP cmp) {
+  std::vector<size_t> seq;
+  const size_t length = quadratic_lis(nums, cmp);
+  bool ok = longest_increasing_subseq(nums.data(), nums.size(), seq, cmp) ==
+            length;
+  for (size_t k = 0; k < seq.size(); ++k)
+    ok = ok && seq[k] < nums.size() &&
+         (k == 0 || (seq[k - 1] < seq[k] && cmp(nums[seq[k - 1]],
+                                                nums[seq[k]])));
+  lis_stream<T, CMP> stream(cmp);
+  for (const auto &x : nums)
+    stream.push(x);
+  return ok && stream.length() == length;
+}
+
+// Checks strict, non-strict and decreasing orders on integers, and strings.
+bool test_small() {
+  for (size_t t = 0; t < TEST_COUNT; ++t) {
+    std::vector<int> nums(rand() % (MAX_TEST_LENGTH + 1));
+    std::vector<std::string> words(nums.size());
+    for (size_t i = 0; i < nums.size(); ++i) {
+      nums[i] = rand() % MAX_TEST_VALUE;
+      words[i] = std::string(1 + rand() % 2, 'a' + rand() % 3);
+    }
+    if (!check(nums, std::less<int>()) ||
+        !check(nums, std::less_equal<int>()) ||
+        !check(nums, std::greater<int>()) ||
+        !check(words, std::less<std::string>()))
+      return false;
+  }
+  return true;
+}
+
+void print_cell(double v) {
+  std::cout.width(11);
+  if (v < 0)
+    std::cout << "-";
+  else
+    std::cout << v;
+}
+
+int main(int argc, char *argv[]) {
+  srand(A_BIG_PRIME_NUMBER);
+  const size_t max_size = argc > 1 ? std::stoul(argv[1]) : DEFAULT_SIZE;
+
+  // The example of m006_r20_01_lc_increasing_subseq.
+  std::vector<int> nums(15);
+  for (auto &x : nums)
+    x = rand() % 100;
+  for (auto x : nums)
+    std::cout << x << " ";
+  std::cout << std::endl;
+
+  std::vector<size_t> seq;
+  std::cout << "Longest increasing subsequence: " << std::endl;
+  longest_increasing_subseq(nums.data(), nums.size(), seq);
+  for (auto i : seq)
+    std::cout << nums[i] << " ";
+  std::cout << std::endl;
+  std::cout << "Longest non-decreasing subsequence: " << std::endl;
+  longest_increasing_subseq(nums.data(), nums.size(), seq,
+                            std::less_equal<int>());
+  for (auto i : seq)
+    std::cout << nums[i] << " ";
+  std::cout << std::endl << std::endl;
+
+  bool ok = test_small();
+  std::cout << "Small sequences: " << (ok ? "match" : "MISMATCH") << std::endl
+            << std::endl;
+
+  // Random integers have a longest increasing subsequence of about 2 sqrt(N);
+  // a trend with noise has one of a sizeable fraction of N, and many more
+  // piles to search.
+  std::cout << "Time (ms); stream is lis_stream, length only" << std::endl
+            << "         N    data     length  quadratic   patience"
+            << "     stream  Melems/s" << std::endl;
+  for (size_t N = std::min<size_t>(10000, max_size);;
+       N = std::min(N * 10, max_size)) {
+    for (bool trend : {false, true}) {
+      nums.resize(N);
+      for (size_t i = 0; i < N; ++i)
+        nums[i] = trend ? static_cast<int>(i / 4 + rand() % 64) : rand();
+
+      double t_quadratic = -1;
+      size_t length = SIZE_MAX;
+      if (N <= QUADRATIC_MAX_SIZE) {
+        auto t = std::chrono::high_resolution_clock::now();
+        length = quadratic_lis(nums, std::less<int>());
+        t_quadratic = elapsed_ms(t);
+      }
+
+      auto t = std::chrono::high_resolution_clock::now();
+      const size_t l = longest_increasing_subseq(nums.data(), N, seq);
+      const double t_patience = elapsed_ms(t);
+      for (size_t k = 1; k < seq.size(); ++k)
+        ok = ok && seq[k - 1] < seq[k] && nums[seq[k - 1]] < nums[seq[k]];
+
+      t = std::chrono::high_resolution_clock::now();
+      lis_stream<int> stream;
+      for (auto x : nums)
+        stream.push(x);
+      const double t_stream = elapsed_ms(t);
+
+      ok = ok && (length == SIZE_MAX || length == l) &&
+           stream.length() == l;
+
+      std::cout.width(10);
+      std::cout << N;
+      std::cout << (trend ? "   trend" : "  random");
+      std::cout.width(11);
+      std::cout << l;
+      print_cell(t_quadratic);
+      print_cell(t_patience);
+      print_cell(t_stream);
+      print_cell(N / (t_stream * 1000));
+      std::cout << std::endl;
+    }
+    if (N == max_size)
+      break;
+  }
+
+  std::cout << (ok ? "Results match" : "MISMATCH") << std::endl;
+  return ok ? 0 : 1;
+}
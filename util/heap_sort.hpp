@@ -0,0 +1,91 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <vector>
+
+namespace heap_util {
+// No child index.
+constexpr int INVALID = -1;
+
+inline int parent(int idx) { return (idx - 1) / 2; }
+inline int left(int idx) { return 2 * idx + 1; }
+inline int right(int idx) { return 2 * idx + 2; }
+} // namespace heap_util
+
+struct heap_store {
+  std::vector<int> v;
+  int len;
+};
+
+// Returns index of the child with higher priority as per
+// the comparison function cmp.
+template <typename CMP>
+int get_pri_child_idx(int idx, const heap_store &h, CMP cmp) {
+  int child_idx = heap_util::INVALID;
+  int ri = heap_util::right(idx);
+  if (ri < h.len) {
+    child_idx = ri;
+  }
+
+  int li = heap_util::left(idx);
+  if (li < h.len) {
+    if (child_idx == heap_util::INVALID || cmp(h.v[li], h.v[child_idx])) {
+      child_idx = li;
+    }
+  }
+
+  return child_idx;
+}
+
+// Fix disorder at index idx if the priority of the element
+// at idx is lower than any of its children by swaping the
+// element with the higher priority child. Recursively
+// fix any disorder at the higher priority child index after swap.
+template <typename CMP> void heapify(int idx, heap_store &h, CMP cmp) {
+  if (idx >= h.len)
+    return;
+  auto ci = get_pri_child_idx(idx, h, cmp);
+
+  if (ci != heap_util::INVALID && !cmp(h.v[idx], h.v[ci])) {
+    auto tmp = h.v[idx];
+    h.v[idx] = h.v[ci];
+    h.v[ci] = tmp;
+    heapify(ci, h, cmp);
+  }
+}
+
+// Convert an unordered array into a heap in a bottom up manner.
+template <typename CMP> void build_heap(heap_store &h, CMP cmp) {
+  // Leaves, index (len + 1) / 2 + 1 onwards, are already
+  // trivial heaps.
+  for (int idx = (h.len + 1) / 2; idx >= 0; --idx) {
+    heapify(idx, h, cmp);
+  }
+}
+
+// Swap the top element with the last elemet.
+// Reduce the heap length by 1. Fix the disorder at top.
+template <typename CMP> int extract_top(heap_store &h, CMP cmp) {
+  int top = h.v[0];
+  h.v[0] = h.v[h.len - 1];
+  h.v[h.len - 1] = top;
+
+  --h.len;
+
+  heapify(0, h, cmp);
+  return top;
+}
+
+// Keep extracting the top element (thus add it to the end of the heap array).
+template <typename CMP> void heap_sort(heap_store &h, CMP cmp) {
+  build_heap(h, cmp);
+  while (h.len > 1) {
+    extract_top(h, cmp);
+  }
+}
@@ -0,0 +1,79 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <algorithm>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// RAII read-only memory map of a whole file.
+// The contents are accessed in place through the page cache; no copy into
+// user buffers. An empty file maps to a valid, zero length view.
+class mapped_file {
+private:
+  const char *mData;
+  size_t mSize;
+  bool mValid;
+
+public:
+  explicit mapped_file(const std::string &fname)
+      : mData(nullptr), mSize(0), mValid(false) {
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+      mSize = st.st_size;
+      if (mSize == 0) {
+        mValid = true;
+      } else {
+        void *addr = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+          // Hint the kernel to read ahead aggressively.
+          madvise(addr, mSize, MADV_SEQUENTIAL);
+          mData = static_cast<const char *>(addr);
+          mValid = true;
+        } else {
+          mSize = 0;
+        }
+      }
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  ~mapped_file() {
+    if (mData)
+      munmap(const_cast<char *>(mData), mSize);
+  }
+
+  bool valid() const { return mValid; }
+
+  const char *data() const { return mData; }
+
+  size_t size() const { return mSize; }
+
+  // Drops the pages wholly inside [from, to) from the process; they are
+  // read back from the file if touched again. Keeps the resident memory of
+  // a streaming pass bounded.
+  void release(size_t from, size_t to) {
+    const size_t page = sysconf(_SC_PAGESIZE);
+    from = (from + page - 1) / page * page;
+    to = std::min(to, mSize) / page * page;
+    if (mData && from < to)
+      madvise(const_cast<char *>(mData) + from, to - from, MADV_DONTNEED);
+  }
+};
@@ -0,0 +1,56 @@
+//
+// Copyright 2021 Santanu Sen. All Rights Reserved.
+//
+// Licensed under the Apache License 2.0 (the "License"). You may not use
+// this file except in compliance with the License. You can obtain a copy
+// in the file LICENSE in the source distribution.
+//
+
+#pragma once
+#include <vector>
+
+// Merge routine: merges two sorted arrays A and B into a third
+// sorted array C.
+inline void merge_sorted(int *A, int m, int *B, int n, int *C) {
+  int i = 0, j = 0, k = 0;
+  while (i < m && j < n) {
+    if (A[i] < B[j])
+      C[k++] = A[i++];
+    else
+      C[k++] = B[j++];
+  }
+
+  while (i < m)
+    C[k++] = A[i++];
+  while (j < n)
+    C[k++] = B[j++];
+}
+
+// Iterative merge sort using 2-way merge.
+inline void two_way_merge_sort(int *arr, int n) {
+  std::vector<int> aux(n);
+  int *cur = arr, *nxt = aux.data();
+
+  // Start with merging sub-arrays of size 1.
+  // At each iteration double the size of input sub-arrays.
+  // The array used as the input array at one iteration
+  // becomes the output array in the next and vice versa.
+  for (int step = 1; step < n; step *= 2) {
+    for (int i = 0; i < n; i += 2 * step) {
+      merge_sorted(cur + i, ((i + step < n) ? step : n - i),   // A, m
+                   cur + i + step,                             // B
+                   ((i + 2 * step < n) ? step : n - i - step), // n
+                   nxt + i);                                   // C
+    }
+
+    // Swap the current and next arrays.
+    int *tmp = cur;
+    cur = nxt;
+    nxt = tmp;
+  }
+
+  if (cur != arr) {
+    for (int i = 0; i < n; ++i)
+      arr[i] = cur[i];
+  }
+}